@@ -0,0 +1,239 @@
+/// \file autotuner.cpp
+/** \brief Alat koji mjeri kernele na lokalnom računaru i pravi profil podešavanja.
+*
+*   Mjeri klasično, Strassenovo i Morton množenje (prag rekurzije i list), transponovanje s različitim blokovima,
+*   inverznu matricu kofaktorima i LU rastavom, stepenovanje, te skaliranje bazena niti.
+*   Rezultat se upisuje u profil kojeg biblioteka učitava pri pokretanju.
+*   \code
+*   g++ -std=c++17 -O2 -pthread -I. alati/autotuner.cpp $(ls *.cpp | grep -v main.cpp) -o autotuner
+*   ./autotuner [putanja profila] [najveci red]
+*   \endcode
+*   @see <code> static bool Matrica::ucitajProfil(const string& putanja); </code>
+*/
+
+#include "matrica.h"
+#include "bazen.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <functional>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+
+using namespace std;
+
+static mt19937 generator(12345);
+
+/// Najkraće od nekoliko mjerenja, svako ponavlja posao dok ne prođe bar 20 ms; u sekundama po pozivu.
+static double izmjeri(const function<void()>& posao) {
+    double najbolje = 1e300;
+    for (int pokusaj=0; pokusaj<3; pokusaj++) {
+        int ponavljanja = 0;
+        auto pocetak = chrono::steady_clock::now();
+        double proteklo;
+        do {
+            posao();
+            ponavljanja++;
+            proteklo = chrono::duration<double>(chrono::steady_clock::now() - pocetak).count();
+        } while (proteklo < 0.02);
+        najbolje = min(najbolje, proteklo / ponavljanja);
+        // spori kerneli se ne ponavljaju
+        if (proteklo > 1) break;
+    }
+    return najbolje;
+}
+
+/// Slučajna matrica s dominantnom dijagonalom (regularna), zadata kroz parser.
+static Matrica slucajna(int n) {
+    uniform_int_distribution<int> d(-9, 9);
+    ostringstream s;
+    s << "[";
+    for (int i=0; i<n; i++) {
+        for (int j=0; j<n; j++) s << (i == j ? 10 * n : d(generator)) << " ";
+        if (i < n-1) s << ";";
+    }
+    s << "]\n";
+    istringstream ulaz(s.str());
+    Matrica m;
+    ulaz >> m;
+    return m;
+}
+
+int main(int argc, char** argv) {
+    string putanja = argc > 1 ? argv[1] : Matrica::putanjaProfila();
+    int najveci = argc > 2 ? atoi(argv[2]) : 512;
+    ostringstream mjerenja;
+    try {
+        // polazi se od podrazumijevanih parametara, a ne od postojeceg profila
+        Matrica::pragStrassena = 2;
+        Matrica::listMortona = 32;
+        Matrica::rasporedMnozenja = redovni;
+        Matrica::metodaInverzije = kofaktori;
+        Matrica::pragMjesovite = 0;
+
+        // broj niti: paralelna petlja klasicnog mnozenja u bazenima razlicite velicine
+        int hw = thread::hardware_concurrency() > 0 ? thread::hardware_concurrency() : 1;
+        {
+            int n = 384;
+            vector<double> a((size_t)n*n, 1.0), b((size_t)n*n, 1.0), c((size_t)n*n);
+            auto kernel = [&](int od, int doK) {
+                for (int i=od; i<doK; i++)
+                    for (int j=0; j<n; j++) {
+                        double suma = 0;
+                        for (int k=0; k<n; k++) suma += a[(size_t)i*n + k] * b[(size_t)k*n + j];
+                        c[(size_t)i*n + j] = suma;
+                    }
+            };
+            int najbolji = 1;
+            double vrijeme = 1e300;
+            for (int t=1; t<=hw; t = (t == hw ? hw+1 : min(2*t, hw))) {
+                BazenNiti bazen(t - 1);
+                double s = izmjeri([&]() { bazen.paralelno(0, n, kernel); });
+                mjerenja << "# niti " << t << ": " << s << " s\n";
+                // vise niti se uzima samo uz primjetno ubrzanje
+                if (s < 0.95 * vrijeme) {
+                    vrijeme = s;
+                    najbolji = t;
+                }
+            }
+            BazenNiti::nitiGlobalnog = najbolji == hw ? 0 : najbolji;
+        }
+
+        // paralelno klasicno mnozenje: najmanji red od kojeg se dijeljenje na niti isplati
+        {
+            Matrica::pragStrassena = 1 << 30;
+            double prag = 1e300;
+            // s jednom niti nema sta da se dijeli
+            int doReda = BazenNiti::globalni().brojNiti() > 1 ? min(najveci, 256) : 0;
+            for (int n=16; n<=doReda; n = n*3/2) {
+                Matrica a(slucajna(n)), b(slucajna(n));
+                Matrica::pragParalelnog = 1e300;
+                double serijski = izmjeri([&]() { Matrica c(a * b); });
+                Matrica::pragParalelnog = 0;
+                double paralelni = izmjeri([&]() { Matrica c(a * b); });
+                mjerenja << "# klasicno " << n << ": serijski " << serijski << " s, paralelno " << paralelni << " s\n";
+                if (paralelni < 0.9 * serijski) {
+                    prag = (double)n*n*n;
+                    break;
+                }
+            }
+            Matrica::pragParalelnog = prag;
+        }
+
+        // mnozenje: list Morton rasporeda, pa prag rekurzije Strassena u oba rasporeda, na najvecem stepenu broja 2
+        {
+            int n = 8;
+            while (2*n <= najveci) n *= 2;
+            Matrica a(slucajna(n)), b(slucajna(n));
+            Matrica::pragStrassena = 1 << 30;
+            double najbrze = izmjeri([&]() { Matrica c(a * b); });
+            mjerenja << "# mnozenje " << n << ": klasicno " << najbrze << " s\n";
+            int prag = 1 << 30;
+            raspored izabrani = redovni;
+
+            // list se mjeri uz punu rekurziju, kad se klasicno mnozi samo unutar listova
+            Matrica::pragStrassena = 2;
+            Matrica::rasporedMnozenja = morton;
+            double vrijeme = 1e300;
+            int najboljiList = Matrica::listMortona;
+            for (int list : {16, 32, 64, 128}) {
+                if (list > n) break;
+                Matrica::listMortona = list;
+                double s = izmjeri([&]() { Matrica c(a * b); });
+                mjerenja << "# morton " << n << ", list " << list << ": " << s << " s\n";
+                if (s < vrijeme) {
+                    vrijeme = s;
+                    najboljiList = list;
+                }
+            }
+            Matrica::listMortona = najboljiList;
+
+            // prag je red ispod kojeg se podmatrice u rekurziji mnoze klasicno
+            for (raspored r : {redovni, morton}) {
+                Matrica::rasporedMnozenja = r;
+                for (int p=16; p<=n && p<=256; p*=2) {
+                    Matrica::pragStrassena = p;
+                    double s = izmjeri([&]() { Matrica c(a * b); });
+                    mjerenja << "# mnozenje " << n << ": " << (r == morton ? "morton" : "strassen")
+                             << ", prag " << p << ": " << s << " s\n";
+                    if (s < najbrze) {
+                        najbrze = s;
+                        prag = p;
+                        izabrani = r;
+                    }
+                }
+            }
+            Matrica::pragStrassena = prag;
+            Matrica::rasporedMnozenja = izabrani;
+        }
+
+        // stepenovanje sa izabranim mnozenjem; ukoliko je sporije od klasicnog, prag se povecava
+        {
+            int izabrani = Matrica::pragStrassena;
+            for (int n=8; n<=najveci && n<=256; n*=2) {
+                Matrica a(slucajna(n));
+                a = a * (1.0 / (10 * n));
+                Matrica::pragStrassena = izabrani;
+                double s = izmjeri([&]() { Matrica c(a ^ 16); });
+                Matrica::pragStrassena = 1 << 30;
+                double klasicno = izmjeri([&]() { Matrica c(a ^ 16); });
+                mjerenja << "# stepen " << n << "^16: izabrano " << s << " s, klasicno " << klasicno << " s\n";
+                if (n >= izabrani && klasicno < s) izabrani = 2*n;
+            }
+            Matrica::pragStrassena = izabrani;
+        }
+
+        // transponovanje: dimenzija bloka
+        {
+            int n = min(max(najveci, 256), 2048);
+            Matrica a(n, n);
+            double vrijeme = 1e300;
+            int najbolji = Matrica::blokTransponovanja;
+            for (int blok : {8, 16, 32, 64, 128}) {
+                Matrica::blokTransponovanja = blok;
+                double s = izmjeri([&]() { Matrica t(a.transponovana()); });
+                mjerenja << "# transponovanje " << n << ", blok " << blok << ": " << s << " s\n";
+                if (s < vrijeme) {
+                    vrijeme = s;
+                    najbolji = blok;
+                }
+            }
+            Matrica::blokTransponovanja = najbolji;
+        }
+
+        // inverzna: kofaktori (n! operacija) protiv LU rastava
+        {
+            // 0 bi znacilo da se nikad ne prelazi na LU, a kofaktori su O(n!): ukoliko LU ne pobijedi
+            // ni na jednom mjerenom redu, prelazi se na prvom redu iza mjerenih
+            const int najveciMjereni = 9;
+            int prag = najveciMjereni + 1;
+            for (int n=2; n<=najveciMjereni; n++) {
+                Matrica a(slucajna(n));
+                double kofaktori = izmjeri([&]() { Matrica i(a.inverzna()); });
+                double lu = izmjeri([&]() { Matrica i(a.inverznaMjesovita()); });
+                mjerenja << "# inverzna " << n << ": kofaktori " << kofaktori << " s, LU " << lu << " s\n";
+                if (lu < kofaktori) {
+                    prag = n;
+                    break;
+                }
+            }
+            Matrica::pragMjesovite = prag;
+        }
+    } catch (const char* greska) {
+        cout << greska << endl;
+        return 1;
+    }
+
+    if (!Matrica::zapisiProfil(putanja)) {
+        cout << "Profil se ne moze zapisati: " << putanja << endl;
+        return 1;
+    }
+    ofstream izlaz(putanja, ios::app);
+    izlaz << mjerenja.str();
+    cout << mjerenja.str();
+    cout << "Profil zapisan: " << putanja << endl;
+    return 0;
+}
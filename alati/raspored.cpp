@@ -0,0 +1,117 @@
+/// \file raspored.cpp
+/** \brief Alat koji poredi redovni i Morton (Z) raspored na velikim matricama.
+*
+*   Za redove 1024, 2048, ... do zadatog najvećeg mjeri vrijeme i promašaje keša za Strassenovo
+*   množenje u oba rasporeda, za transponovanje po blokovima i rekurzivno transponovanje u Z
+*   rasporedu (sam kernel i s prevođenjem), te za prevođenje u Z raspored. Koriste se parametri
+*   iz profila podešavanja (prag Strassena, list Mortona, blok transponovanja).
+*   \code
+*   g++ -std=c++17 -O2 -pthread -I. alati/raspored.cpp $(ls *.cpp | grep -v main.cpp) -o raspored
+*   ./raspored [najveci red] [najveci red za mnozenje]
+*   \endcode
+*   Promašaji keša (posljednji nivo) se čitaju brojačima procesora kroz \c perf_event_open; ukoliko
+*   brojači nisu dostupni (npr. u kontejneru), ispisuje se samo vrijeme.
+*   @see <code> static raspored Matrica::rasporedMnozenja; </code>
+*/
+
+#include "matrica.h"
+#include <iostream>
+#include <functional>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+/// Brojač promašaja keša posljednjeg nivoa za pozivajuću nit; -1 ukoliko nije dostupan.
+static int otvoriBrojac() {
+#ifdef __linux__
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#else
+    return -1;
+#endif
+}
+
+struct Mjerenje {
+    double sekunde;
+    long long promasaji;
+};
+
+/// Jedno izvršavanje posla (veliki redovi traju dovoljno dugo), uz promašaje keša ako su dostupni.
+static Mjerenje izmjeri(const function<void()>& posao) {
+    int brojac = otvoriBrojac();
+#ifdef __linux__
+    if (brojac >= 0) {
+        ioctl(brojac, PERF_EVENT_IOC_RESET, 0);
+        ioctl(brojac, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+    auto pocetak = chrono::steady_clock::now();
+    posao();
+    Mjerenje m;
+    m.sekunde = chrono::duration<double>(chrono::steady_clock::now() - pocetak).count();
+    m.promasaji = -1;
+#ifdef __linux__
+    if (brojac >= 0) {
+        ioctl(brojac, PERF_EVENT_IOC_DISABLE, 0);
+        long long vrijednost;
+        if (read(brojac, &vrijednost, sizeof(vrijednost)) == sizeof(vrijednost)) m.promasaji = vrijednost;
+        close(brojac);
+    }
+#endif
+    return m;
+}
+
+static void ispisi(const string& naziv, int n, const Mjerenje& m) {
+    cout << naziv << " " << n << ": " << m.sekunde << " s";
+    if (m.promasaji >= 0) cout << ", " << m.promasaji << " promasaja kesa";
+    cout << endl;
+}
+
+int main(int argc, char** argv) {
+    int najveci = argc > 1 ? atoi(argv[1]) : 2048;
+    int najveciMnozenje = argc > 2 ? atoi(argv[2]) : najveci;
+    cout << "# prag Strassena " << Matrica::pragStrassena << ", list Mortona " << Matrica::listMortona
+         << ", blok transponovanja " << Matrica::blokTransponovanja << endl;
+    if (otvoriBrojac() < 0) cout << "# brojaci promasaja kesa nisu dostupni" << endl;
+    try {
+        for (int n=1024; n<=najveci; n*=2) {
+            // sadrzaj ne utice na trajanje, jer nijedan od mjerenih kernela ne preskace nule
+            Matrica a(n), b(n);
+
+            ispisi("prevodjenje u Z", n, izmjeri([&]() { delete [] uMorton(a, n); }));
+
+            ispisi("transponovanje po blokovima", n, izmjeri([&]() { Matrica t(a.transponovana()); }));
+            ispisi("transponovanje kroz Z", n, izmjeri([&]() { Matrica t(transponovanaMorton(a, n)); }));
+            double* z = uMorton(a, n);
+            double* t = new double[(size_t)n * n];
+            ispisi("transponovanje u Z (kernel)", n, izmjeri([&]() { transponujMorton(z, t, n); }));
+            delete [] z;
+            delete [] t;
+
+            if (n > najveciMnozenje) continue;
+            Matrica::rasporedMnozenja = redovni;
+            ispisi("strassen redovni", n, izmjeri([&]() { Matrica c(a * b); }));
+            Matrica::rasporedMnozenja = morton;
+            ispisi("strassen morton", n, izmjeri([&]() { Matrica c(a * b); }));
+        }
+    } catch (const char* greska) {
+        cout << greska << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,209 @@
+/// \file azuriranje.cpp
+
+#include "azuriranje.h"
+#include <cmath>
+#include <vector>
+#include <limits>
+
+using namespace std;
+
+/** \brief Gauss-Jordanova eliminacija s djelimičnim pivotiranjem.
+*
+*   Matrica \c m (n*n elemenata, red po red) se uništava, a u \c inv se upisuje njena inverzna.
+*   @return Determinanta matrice, 0 ukoliko je matrica singularna.
+*/
+static double gaussJordan(vector<double>& m, vector<double>& inv, int n) {
+    inv.assign((size_t)n * n, 0);
+    for (int i=0; i<n; i++) inv[(size_t)i*n + i] = 1;
+    double det = 1;
+    for (int k=0; k<n; k++) {
+        int pivot = k;
+        for (int i=k+1; i<n; i++)
+            if (fabs(m[(size_t)i*n + k]) > fabs(m[(size_t)pivot*n + k])) pivot = i;
+        if (m[(size_t)pivot*n + k] == 0) return 0;
+        if (pivot != k) {
+            for (int j=0; j<n; j++) {
+                swap(m[(size_t)k*n + j], m[(size_t)pivot*n + j]);
+                swap(inv[(size_t)k*n + j], inv[(size_t)pivot*n + j]);
+            }
+            det = -det;
+        }
+        double p = m[(size_t)k*n + k];
+        det *= p;
+        for (int j=0; j<n; j++) {
+            m[(size_t)k*n + j] /= p;
+            inv[(size_t)k*n + j] /= p;
+        }
+        for (int i=0; i<n; i++) {
+            if (i == k) continue;
+            double f = m[(size_t)i*n + k];
+            if (f == 0) continue;
+            for (int j=0; j<n; j++) {
+                m[(size_t)i*n + j] -= f * m[(size_t)k*n + j];
+                inv[(size_t)i*n + j] -= f * inv[(size_t)k*n + j];
+            }
+        }
+    }
+    return det;
+}
+
+PracenaInverzna::PracenaInverzna(const Matrica& a, double tolerancija):
+    a(a), inv(a), det(0), tolerancija(tolerancija), refaktorizacija(0), generator(12345) {
+    if (a.redovi != a.kolone)
+        throw "Samo kvadratne matrice imaju odgovarajucu inverznu matricu!";
+    refaktorisi();
+}
+
+void PracenaInverzna::refaktorisi() {
+    int n = a.redovi;
+    vector<double> m((size_t)n * n), rez;
+    for (int i=0; i<n; i++)
+        for (int j=0; j<n; j++) m[(size_t)i*n + j] = a.matrica[i][j];
+    // det i inv se mijenjaju tek kad je rastav uspio
+    double noviDet = gaussJordan(m, rez, n);
+    if (noviDet == 0) throw "Matrica mora biti regularna da bi imala inverznu!";
+    det = noviDet;
+    for (int i=0; i<n; i++)
+        for (int j=0; j<n; j++) inv.matrica[i][j] = rez[(size_t)i*n + j];
+    refaktorizacija++;
+}
+
+double PracenaInverzna::rezidual() {
+    int n = a.redovi;
+    // svaka provjera koristi novi vektor znakova, pa se mijenja pravac u kojem se greska mjeri
+    vector<double> x(n), y(n, 0);
+    for (int j=0; j<n; j++) x[j] = generator() & 1 ? 1 : -1;
+    for (int i=0; i<n; i++)
+        for (int j=0; j<n; j++) y[i] += inv.matrica[i][j] * x[j];
+    double greska = 0;
+    for (int i=0; i<n; i++) {
+        double r = -x[i];
+        for (int j=0; j<n; j++) r += a.matrica[i][j] * y[j];
+        greska = fmax(greska, fabs(r));
+    }
+    // ||x|| = 1 u beskonacnoj normi
+    return greska;
+}
+
+double PracenaInverzna::dozvoljeniRezidual() const {
+    int n = a.redovi;
+    // n ||A|| ||A^-1|| eps je red velicine reziduala stabilno izracunate inverzne
+    double normaA = 0, normaInv = 0;
+    for (int i=0; i<n; i++) {
+        double sA = 0, sInv = 0;
+        for (int j=0; j<n; j++) {
+            sA += fabs(a.matrica[i][j]);
+            sInv += fabs(inv.matrica[i][j]);
+        }
+        normaA = fmax(normaA, sA);
+        normaInv = fmax(normaInv, sInv);
+    }
+    return fmax(tolerancija, n * normaA * normaInv * numeric_limits<double>::epsilon());
+}
+
+void PracenaInverzna::primijeni(const Matrica& u, const Matrica& v) {
+    int n = a.redovi, k = u.kolone;
+    // W = A^-1 U (nxk), Z = V^T A^-1 (kxn)
+    vector<double> w((size_t)n * k, 0), z((size_t)k * n, 0);
+    for (int i=0; i<n; i++)
+        for (int j=0; j<n; j++) {
+            double p = inv.matrica[i][j];
+            for (int c=0; c<k; c++) {
+                w[(size_t)i*k + c] += p * u.matrica[j][c];
+                z[(size_t)c*n + j] += v.matrica[i][c] * p;
+            }
+        }
+    // S = I + V^T W (kxk)
+    vector<double> s((size_t)k * k, 0), sInv;
+    double skala = 1;
+    for (int c=0; c<k; c++) {
+        s[(size_t)c*k + c] = 1;
+        double normaV = 0, normaW = 0;
+        for (int i=0; i<n; i++) {
+            normaV = fmax(normaV, fabs(v.matrica[i][c]));
+            normaW = fmax(normaW, fabs(w[(size_t)i*k + c]));
+            for (int d=0; d<k; d++) s[(size_t)c*k + d] += v.matrica[i][c] * w[(size_t)i*k + d];
+        }
+        skala *= 1 + n * normaV * normaW;
+    }
+    double detS = gaussJordan(s, sInv, k);
+
+    // A += UV^T; neuspjela izmjena se ponistava oduzimanjem istog proizvoda (tacno do zaokruzivanja),
+    // bez kopije matrice. Elementi gdje je UV^T nula, npr. van zamijenjenog reda, ostaju nepromijenjeni.
+    auto dodajUV = [&](double znak) {
+        for (int i=0; i<n; i++)
+            for (int j=0; j<n; j++) {
+                double p = 0;
+                for (int c=0; c<k; c++) p += u.matrica[i][c] * v.matrica[j][c];
+                a.matrica[i][j] += znak * p;
+            }
+    };
+    dodajUV(1);
+
+    try {
+        // skoro singularan S znaci gubitak tacnosti Woodburyjeve formule, racuna se iznova
+        if (fabs(detS) <= sqrt(numeric_limits<double>::epsilon()) * skala) {
+            refaktorisi();
+            return;
+        }
+        // A^-1 -= W Y, Y = S^-1 Z; W i Y se cuvaju da bi se izmjena inverzne mogla ponistiti
+        vector<double> y((size_t)k * n, 0);
+        for (int c=0; c<k; c++)
+            for (int d=0; d<k; d++)
+                for (int j=0; j<n; j++) y[(size_t)c*n + j] += sInv[(size_t)c*k + d] * z[(size_t)d*n + j];
+        auto oduzmiWY = [&](double znak) {
+            for (int i=0; i<n; i++)
+                for (int c=0; c<k; c++) {
+                    double p = znak * w[(size_t)i*k + c];
+                    for (int j=0; j<n; j++) inv.matrica[i][j] -= p * y[(size_t)c*n + j];
+                }
+        };
+        oduzmiWY(1);
+        double stariDet = det;
+        det *= detS;
+
+        if (rezidual() > dozvoljeniRezidual()) {
+            try {
+                refaktorisi();
+            } catch (...) {
+                oduzmiWY(-1);
+                det = stariDet;
+                throw;
+            }
+        }
+    } catch (...) {
+        // singularna izmjena se ponistava, inverzna i determinanta ostaju ispravne
+        dodajUV(-1);
+        throw;
+    }
+}
+
+void PracenaInverzna::azurirajRang1(const Matrica& u, const Matrica& v) {
+    if (u.redovi != a.redovi || v.redovi != a.redovi || u.kolone != 1 || v.kolone != 1)
+        throw "Vektori izmjene nisu odgovarajucih formata";
+    primijeni(u, v);
+}
+
+void PracenaInverzna::azurirajRangK(const Matrica& u, const Matrica& v) {
+    if (u.redovi != a.redovi || v.redovi != a.redovi || u.kolone != v.kolone)
+        throw "Matrice izmjene nisu odgovarajucih formata";
+    primijeni(u, v);
+}
+
+void PracenaInverzna::zamijeniRed(int i, const Matrica& red) {
+    if (i < 0 || i >= a.redovi || red.redovi != 1 || red.kolone != a.kolone)
+        throw "Ilegalni parametri za zamjenu reda!";
+    Matrica u(a.redovi, 1), v(a.redovi, 1);
+    u.matrica[i][0] = 1;
+    for (int j=0; j<a.kolone; j++) v.matrica[j][0] = red.matrica[0][j] - a.matrica[i][j];
+    primijeni(u, v);
+}
+
+void PracenaInverzna::zamijeniKolonu(int j, const Matrica& kolona) {
+    if (j < 0 || j >= a.kolone || kolona.kolone != 1 || kolona.redovi != a.redovi)
+        throw "Ilegalni parametri za zamjenu kolone!";
+    Matrica u(a.redovi, 1), v(a.redovi, 1);
+    v.matrica[j][0] = 1;
+    for (int i=0; i<a.redovi; i++) u.matrica[i][0] = kolona.matrica[i][0] - a.matrica[i][j];
+    primijeni(u, v);
+}
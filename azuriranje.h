@@ -0,0 +1,77 @@
+/// \file azuriranje.h
+
+#ifndef AZURIRANJE_H
+#define AZURIRANJE_H
+#include <iostream>
+#include <random>
+#include "matrica.h"
+using namespace std;
+
+/** \class PracenaInverzna
+* Kvadratna matrica čija se inverzna matrica i determinanta čuvaju između izmjena.
+*
+* Izmjene niskog ranga (jedan red, jedna kolona, <code> A + UV<sup>T</sup> </code>) se primjenjuju
+* Sherman–Morrison–Woodbury formulom i lemom o determinanti matrice, u vremenu O(n<sup>2</sup>k)
+* umjesto O(n<sup>3</sup>) za ponovno računanje.
+*
+* Nakon svake izmjene provjerava se rezidual <code> ||A*A<sup>-1</sup>x - x|| </code> za novi slučajni
+* vektor \c x (elementi ±1), pa greška ne može trajno ostati neprimijećena u pravcu fiksnog vektora.
+* Ukoliko je odstupanje veće od dozvoljenog, inverzna se računa iznova Gauss-Jordanovom metodom.
+*/
+
+class PracenaInverzna {
+    Matrica a, inv;
+    double det;
+    double tolerancija;
+    int refaktorizacija;
+    mt19937_64 generator;
+
+    void refaktorisi();
+    double rezidual();
+    double dozvoljeniRezidual() const;
+    void primijeni(const Matrica& u, const Matrica& v);
+public:
+
+/** \brief Konstruktor koji računa početnu inverznu matricu.
+*
+*   @param a Kvadratna, regularna matrica.
+*   @param tolerancija Najveći dozvoljeni relativni rezidual prije ponovnog računanja. Za loše uslovljene
+*   matrice granica se povećava na <code> n ||A|| ||A<sup>-1</sup>|| ε </code>, koliko bi imala i iznova
+*   izračunata inverzna, jer bi se inače svaka izmjena završila ponovnim računanjem.
+*   @throw exception Izuzetak se baca ukoliko matrica nije kvadratna ili je singularna.
+*/
+    PracenaInverzna(const Matrica& a, double tolerancija = 1e-9);
+
+/** \brief Izmjena ranga 1: <code> A = A + uv<sup>T</sup> </code>.
+*
+*   @param u Vektor kolona formata nx1.
+*   @param v Vektor kolona formata nx1.
+*   @throw exception Izuzetak se baca ukoliko vektori nisu odgovarajućih formata ili je nova matrica singularna
+*   (tada izmjena nije primijenjena).
+*/
+    void azurirajRang1(const Matrica& u, const Matrica& v);
+
+/** \brief Izmjena ranga k: <code> A = A + UV<sup>T</sup> </code>.
+*
+*   <code> A<sup>-1</sup> = A<sup>-1</sup> - A<sup>-1</sup>U (I + V<sup>T</sup>A<sup>-1</sup>U)<sup>-1</sup> V<sup>T</sup>A<sup>-1</sup> </code>,
+*   a determinanta se množi sa <code> det(I + V<sup>T</sup>A<sup>-1</sup>U) </code>.
+*   @param u Matrica formata nxk.
+*   @param v Matrica formata nxk.
+*/
+    void azurirajRangK(const Matrica& u, const Matrica& v);
+
+/// Zamjena reda \c i novim redom formata 1xn.
+    void zamijeniRed(int i, const Matrica& red);
+
+/// Zamjena kolone \c j novom kolonom formata nx1.
+    void zamijeniKolonu(int j, const Matrica& kolona);
+
+    const Matrica& trenutna() const { return a; }
+    const Matrica& inverzna() const { return inv; }
+    double determinanta() const { return det; }
+
+/// Broj računanja inverzne iznova (uključujući i početno).
+    int brojRefaktorizacija() const { return refaktorizacija; }
+};
+
+#endif // AZURIRANJE_H
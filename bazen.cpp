@@ -0,0 +1,106 @@
+/// \file bazen.cpp
+
+#include "bazen.h"
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <limits>
+
+using namespace std;
+
+BazenNiti::BazenNiti(int brojNiti): brojac(0), kraj(false) {
+    for (int i=0; i<brojNiti; i++)
+        niti.push_back(thread(&BazenNiti::radi, this));
+}
+
+BazenNiti::~BazenNiti() {
+    {
+        lock_guard<mutex> l(zakljucavanje);
+        kraj = true;
+    }
+    signal.notify_all();
+    for (size_t i=0; i<niti.size(); i++) niti[i].join();
+}
+
+void BazenNiti::radi() {
+    while (true) {
+        Zadatak z;
+        {
+            unique_lock<mutex> l(zakljucavanje);
+            signal.wait(l, [this]() { return kraj || !red.empty(); });
+            if (red.empty()) return;
+            z = red.top();
+            red.pop();
+        }
+        z.posao();
+        zavrsen.notify_all();
+    }
+}
+
+void BazenNiti::dodaj(function<void()> posao, double prioritet) {
+    {
+        lock_guard<mutex> l(zakljucavanje);
+        red.push(Zadatak{prioritet, brojac++, posao});
+    }
+    signal.notify_one();
+}
+
+bool BazenNiti::pokreniJedan() {
+    Zadatak z;
+    {
+        lock_guard<mutex> l(zakljucavanje);
+        if (red.empty()) return false;
+        z = red.top();
+        red.pop();
+    }
+    z.posao();
+    zavrsen.notify_all();
+    return true;
+}
+
+void BazenNiti::cekaj(const function<bool()>& gotovo) {
+    while (!gotovo()) {
+        if (pokreniJedan()) continue;
+        unique_lock<mutex> l(zakljucavanje);
+        zavrsen.wait_for(l, chrono::milliseconds(1));
+    }
+}
+
+void BazenNiti::paralelno(int od, int doK, const function<void(int, int)>& f) {
+    int duzina = doK - od;
+    if (duzina <= 0) return;
+    int dijelova = brojNiti() * 4;
+    if (dijelova > duzina) dijelova = duzina;
+    if (dijelova == 1) {
+        f(od, doK);
+        return;
+    }
+    atomic<int> preostalo(dijelova);
+    exception_ptr greska;
+    mutex zakljucavanjeGreske;
+    for (int d=0; d<dijelova; d++) {
+        int a = od + (long long)duzina * d / dijelova;
+        int b = od + (long long)duzina * (d+1) / dijelova;
+        // zadatak ne smije propustiti izuzetak (npr. bad_alloc), jer bi se ostali dijelovi
+        // izvrsavali nad lokalnim varijablama koje vise ne postoje
+        dodaj([&f, &preostalo, &greska, &zakljucavanjeGreske, a, b]() {
+            try {
+                f(a, b);
+            } catch (...) {
+                lock_guard<mutex> l(zakljucavanjeGreske);
+                if (!greska) greska = current_exception();
+            }
+            preostalo--;
+        }, numeric_limits<double>::infinity());
+    }
+    cekaj([&preostalo]() { return preostalo == 0; });
+    if (greska) rethrow_exception(greska);
+}
+
+int BazenNiti::nitiGlobalnog = 0;
+
+BazenNiti& BazenNiti::globalni() {
+    static BazenNiti bazen(nitiGlobalnog > 0 ? nitiGlobalnog - 1 :
+                           thread::hardware_concurrency() > 1 ? thread::hardware_concurrency() - 1 : 0);
+    return bazen;
+}
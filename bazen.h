@@ -0,0 +1,88 @@
+/// \file bazen.h
+
+#ifndef BAZEN_H
+#define BAZEN_H
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+using namespace std;
+
+/** \class BazenNiti
+* Bazen niti (thread pool) s prioritetnim redom zadataka.
+*
+* Zadaci s većim prioritetom se preuzimaju prvi. Nit koja čeka na rezultat ne spava, već i sama
+* izvršava zadatke iz reda (\c cekaj), pa ugniježđeni paralelizam (npr. paralelna petlja unutar
+* zadatka) koristi iste niti i ne dolazi do preopterećenja jezgara.
+*/
+
+class BazenNiti {
+    struct Zadatak {
+        double prioritet;
+        long long redniBroj;
+        function<void()> posao;
+        bool operator< (const Zadatak& z) const {
+            if (prioritet != z.prioritet) return prioritet < z.prioritet;
+            return redniBroj > z.redniBroj;
+        }
+    };
+    vector<thread> niti;
+    priority_queue<Zadatak> red;
+    long long brojac;
+    mutex zakljucavanje;
+    condition_variable signal, zavrsen;
+    bool kraj;
+
+    void radi();
+public:
+
+/** \brief Konstruktor koji pokreće zadati broj radnih niti.
+*
+*   Broj niti može biti i 0; tada zadatke izvršava isključivo nit koja čeka (\c cekaj).
+*/
+    BazenNiti(int brojNiti);
+
+/// Destruktor čeka da radne niti završe trenutne zadatke.
+    ~BazenNiti();
+
+/// Dodavanje zadatka u red. Zadatak ne smije baciti izuzetak, već ga mora sačuvati za nit koja čeka.
+    void dodaj(function<void()> posao, double prioritet = 0);
+
+/** \brief Izvršavanje jednog zadatka iz reda u pozivajućoj niti.
+*
+*   @return false ukoliko je red prazan.
+*/
+    bool pokreniJedan();
+
+/// Čekanje dok uslov ne bude ispunjen, uz izvršavanje zadataka iz reda.
+    void cekaj(const function<bool()>& gotovo);
+
+/** \brief Paralelna petlja nad intervalom <code> [od, doK) </code>.
+*
+*   Interval se dijeli na dijelove koji se dodaju u red s prioritetom +∞, iznad svakog ranga čvora izraza,
+*   a pozivajuća nit učestvuje u izvršavanju. Prvi izuzetak bačen u nekom dijelu (bilo kojeg tipa)
+*   ponovo se baca nakon što svi dijelovi završe.
+*   @param f Funkcija koja obrađuje podinterval <code> [a, b) </code>.
+*/
+    void paralelno(int od, int doK, const function<void(int, int)>& f);
+
+/// Ukupan broj niti koje izvršavaju zadatke (radne niti i nit koja čeka).
+    int brojNiti() const { return niti.size() + 1; }
+
+/** \brief Zajednički bazen za izračunavanje izraza i kernele.
+*
+*   Ima <code> hardware_concurrency() - 1 </code> radnih niti, jer nit koja čeka i sama radi,
+*   osim ako je postavljeno \c nitiGlobalnog.
+*/
+    static BazenNiti& globalni();
+
+/** \brief Ukupan broj niti zajedničkog bazena, 0 znači <code> hardware_concurrency() </code>.
+*
+*   Mora se postaviti prije prvog poziva <code> static BazenNiti& globalni(); </code>, npr. iz profila podešavanja.
+*/
+    static int nitiGlobalnog;
+};
+
+#endif // BAZEN_H
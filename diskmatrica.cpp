@@ -0,0 +1,279 @@
+/// \file diskmatrica.cpp
+
+#include "diskmatrica.h"
+#include "bazen.h"
+#include <fstream>
+#include <filesystem>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <limits>
+
+using namespace std;
+
+size_t DiskMatrica::budzetMemorije = size_t(256) << 20;
+
+static const long long velicinaZaglavlja = 3 * sizeof(int);
+
+DiskMatrica::DiskMatrica(const string& putanja, int redovi, int kolone, int blok):
+    putanja(putanja), redovi(redovi), kolone(kolone), blok(blok), privremena(false) {
+    if (redovi <= 0 || kolone <= 0 || blok <= 0)
+        throw "Neispravan format matrice na disku!";
+    this->blokRedova = (redovi + blok - 1) / blok;
+    this->blokKolona = (kolone + blok - 1) / blok;
+
+    ofstream izlaz(putanja, ios::binary | ios::trunc);
+    if (!izlaz) throw "Datoteka matrice se ne moze kreirati!";
+    int zaglavlje[3] = {redovi, kolone, blok};
+    izlaz.write((const char*)zaglavlje, sizeof(zaglavlje));
+    izlaz.close();
+    // prosirivanje datoteke nulama, bez pisanja svakog bloka
+    filesystem::resize_file(putanja, pozicijaBloka(blokRedova, 0));
+}
+
+DiskMatrica::DiskMatrica(const string& putanja): putanja(putanja), privremena(false) {
+    ifstream ulaz(putanja, ios::binary);
+    if (!ulaz) throw "Datoteka matrice ne postoji!";
+    int zaglavlje[3];
+    if (!ulaz.read((char*)zaglavlje, sizeof(zaglavlje)))
+        throw "Neispravno zaglavlje matrice na disku!";
+    this->redovi = zaglavlje[0];
+    this->kolone = zaglavlje[1];
+    this->blok = zaglavlje[2];
+    if (redovi <= 0 || kolone <= 0 || blok <= 0)
+        throw "Neispravno zaglavlje matrice na disku!";
+    this->blokRedova = (redovi + blok - 1) / blok;
+    this->blokKolona = (kolone + blok - 1) / blok;
+}
+
+DiskMatrica::DiskMatrica(DiskMatrica&& r):
+    putanja(move(r.putanja)), redovi(r.redovi), kolone(r.kolone), blok(r.blok),
+    blokRedova(r.blokRedova), blokKolona(r.blokKolona), privremena(r.privremena) {
+    r.putanja.clear();
+    r.privremena = false;
+}
+
+DiskMatrica& DiskMatrica::operator= (DiskMatrica&& r) {
+    if (this != &r) {
+        if (privremena) {
+            error_code greska;
+            filesystem::remove(putanja, greska);
+        }
+        putanja = move(r.putanja);
+        redovi = r.redovi;
+        kolone = r.kolone;
+        blok = r.blok;
+        blokRedova = r.blokRedova;
+        blokKolona = r.blokKolona;
+        privremena = r.privremena;
+        r.putanja.clear();
+        r.privremena = false;
+    }
+    return *this;
+}
+
+DiskMatrica::~DiskMatrica() {
+    if (privremena) {
+        // destruktor ne smije baciti izuzetak, pa se greska brisanja zanemaruje
+        error_code greska;
+        filesystem::remove(putanja, greska);
+    }
+}
+
+void DiskMatrica::preimenuj(const string& nova) {
+    error_code greska;
+    filesystem::rename(putanja, nova, greska);
+    if (greska) {
+        // rename ne radi izmedju razlicitih datotecnih sistema (npr. /tmp)
+        if (!filesystem::copy_file(putanja, nova, filesystem::copy_options::overwrite_existing, greska))
+            throw "Datoteka matrice se ne moze premjestiti!";
+        filesystem::remove(putanja, greska);
+    }
+    putanja = nova;
+    privremena = false;
+}
+
+string DiskMatrica::privremenaPutanja() {
+    static atomic<int> brojac(0);
+    string ime = "matrica_" + to_string(chrono::steady_clock::now().time_since_epoch().count())
+                 + "_" + to_string(brojac++) + ".blk";
+    return (filesystem::temp_directory_path() / ime).string();
+}
+
+long long DiskMatrica::pozicijaBloka(int i, int j) const {
+    return velicinaZaglavlja + ((long long)i * blokKolona + j) * blok * blok * (long long)sizeof(double);
+}
+
+int DiskMatrica::blokZaBudzet(size_t budzet) {
+    size_t elemenata = budzet / (5 * sizeof(double));
+    int b = 1;
+    while ((size_t)(b+1) * (b+1) <= elemenata) b++;
+    return b;
+}
+
+void DiskMatrica::ucitajBlok(istream& ulaz, int i, int j, double* odrediste) const {
+    ulaz.seekg(pozicijaBloka(i, j));
+    if (!ulaz.read((char*)odrediste, (streamsize)blok * blok * sizeof(double)))
+        throw "Greska pri citanju bloka matrice s diska!";
+}
+
+void DiskMatrica::zapisiBlok(ostream& izlaz, int i, int j, const double* izvor) const {
+    izlaz.seekp(pozicijaBloka(i, j));
+    if (!izlaz.write((const char*)izvor, (streamsize)blok * blok * sizeof(double)))
+        throw "Greska pri pisanju bloka matrice na disk!";
+}
+
+void DiskMatrica::ucitajBlok(int i, int j, double* odrediste) const {
+    ifstream ulaz(putanja, ios::binary);
+    ucitajBlok(ulaz, i, j, odrediste);
+}
+
+void DiskMatrica::zapisiBlok(int i, int j, const double* izvor) {
+    fstream izlaz(putanja, ios::binary | ios::in | ios::out);
+    zapisiBlok(izlaz, i, j, izvor);
+}
+
+DiskMatrica DiskMatrica::izMatrice(const Matrica& m, const string& putanja, int blok) {
+    DiskMatrica rez(putanja, m.redovi, m.kolone, blok);
+    fstream izlaz(putanja, ios::binary | ios::in | ios::out);
+    vector<double> b((size_t)blok * blok);
+    for (int bi=0; bi<rez.blokRedova; bi++) {
+        for (int bj=0; bj<rez.blokKolona; bj++) {
+            fill(b.begin(), b.end(), 0);
+            for (int i=0; i<blok && bi*blok+i < m.redovi; i++)
+                for (int j=0; j<blok && bj*blok+j < m.kolone; j++)
+                    b[(size_t)i*blok + j] = m.matrica[bi*blok+i][bj*blok+j];
+            rez.zapisiBlok(izlaz, bi, bj, b.data());
+        }
+    }
+    return rez;
+}
+
+DiskMatrica DiskMatrica::privremenaIzMatrice(const Matrica& m, int blok) {
+    string putanja = privremenaPutanja();
+    try {
+        DiskMatrica rez(izMatrice(m, putanja, blok));
+        rez.privremena = true;
+        return rez;
+    } catch (const char*) {
+        error_code greska;
+        filesystem::remove(putanja, greska);
+        throw;
+    }
+}
+
+Matrica DiskMatrica::uMatricu() const {
+    Matrica rez(redovi, kolone, neinicijalizovana);
+    ifstream ulaz(putanja, ios::binary);
+    vector<double> b((size_t)blok * blok);
+    for (int bi=0; bi<blokRedova; bi++) {
+        for (int bj=0; bj<blokKolona; bj++) {
+            ucitajBlok(ulaz, bi, bj, b.data());
+            for (int i=0; i<blok && bi*blok+i < redovi; i++)
+                for (int j=0; j<blok && bj*blok+j < kolone; j++)
+                    rez.matrica[bi*blok+i][bj*blok+j] = b[(size_t)i*blok + j];
+        }
+    }
+    return rez;
+}
+
+DiskMatrica DiskMatrica::pomnozi(const DiskMatrica& a, const string& putanja, size_t budzet) const {
+    if (this->kolone != a.redovi)
+        throw "Matrice nisu kompatibilne za mnozenje";
+    if (this->blok != a.blok)
+        throw "Matrice na disku moraju imati iste dimenzije blokova!";
+    if (blokZaBudzet(budzet) < blok)
+        throw "Memorijski budzet nije dovoljan za dimenziju bloka!";
+    if (putanja == this->putanja || putanja == a.putanja)
+        throw "Rezultat ne moze prepisati operand!";
+
+    DiskMatrica rez(putanja, this->redovi, a.kolone, blok);
+    size_t n = (size_t)blok * blok;
+    vector<double> tekuciA(n), tekuciB(n), sljedeciA(n), sljedeciB(n), c(n);
+
+    // po jedan tok za svaku datoteku tokom cijelog mnozenja; tokove operanada koristi samo prefetch,
+    // a tok rezultata samo pozivajuca nit
+    ifstream ulazA(this->putanja, ios::binary), ulazB(a.putanja, ios::binary);
+    fstream izlaz(putanja, ios::binary | ios::in | ios::out);
+    if (!ulazA || !ulazB || !izlaz) throw "Datoteka matrice ne postoji!";
+
+    // blokovi se obilaze redom (i, j, k), pa se za svaki C(i,j) sumira po k
+    int K = this->blokKolona;
+    long long ukupno = (long long)rez.blokRedova * rez.blokKolona * K;
+    ucitajBlok(ulazA, 0, 0, tekuciA.data());
+    a.ucitajBlok(ulazB, 0, 0, tekuciB.data());
+
+    // prefetch je zadatak u zajednickom bazenu, pa mnozenje ne pokrece nove niti
+    BazenNiti& bazen = BazenNiti::globalni();
+    atomic<bool> ucitano(true);
+    exception_ptr greska;
+    auto sacekajUcitavanje = [&bazen, &ucitano]() {
+        bazen.cekaj([&ucitano]() { return ucitano.load(); });
+    };
+
+    for (long long t=0; t<ukupno; t++) {
+        int k = t % K;
+        int j = (t / K) % rez.blokKolona;
+        int i = t / K / rez.blokKolona;
+
+        if (t+1 < ukupno) {
+            int sk = (t+1) % K;
+            int sj = ((t+1) / K) % rez.blokKolona;
+            int si = (t+1) / K / rez.blokKolona;
+            double* pa = sljedeciA.data();
+            double* pb = sljedeciB.data();
+            ucitano = false;
+            bazen.dodaj([this, &a, &ulazA, &ulazB, &ucitano, &greska, si, sj, sk, pa, pb]() {
+                try {
+                    this->ucitajBlok(ulazA, si, sk, pa);
+                    a.ucitajBlok(ulazB, sk, sj, pb);
+                } catch (...) {
+                    greska = current_exception();
+                }
+                ucitano = true;
+            }, numeric_limits<double>::infinity());
+        }
+
+        try {
+            if (k == 0) fill(c.begin(), c.end(), 0);
+            const double* pa = tekuciA.data();
+            const double* pb = tekuciB.data();
+            double* pc = c.data();
+            for (int x=0; x<blok; x++)
+                for (int y=0; y<blok; y++) {
+                    double l = pa[(size_t)x*blok + y];
+                    if (l == 0) continue;
+                    for (int z=0; z<blok; z++)
+                        pc[(size_t)x*blok + z] += l * pb[(size_t)y*blok + z];
+                }
+            if (k == K-1) rez.zapisiBlok(izlaz, i, j, pc);
+        } catch (...) {
+            // zadatak koristi lokalne tokove i nizove, pa mora zavrsiti prije izlaska
+            sacekajUcitavanje();
+            throw;
+        }
+
+        sacekajUcitavanje();
+        if (greska) rethrow_exception(greska);
+        tekuciA.swap(sljedeciA);
+        tekuciB.swap(sljedeciB);
+    }
+    izlaz.flush();
+    if (!izlaz) throw "Greska pri pisanju bloka matrice na disk!";
+    return rez;
+}
+
+DiskMatrica DiskMatrica::operator* (const DiskMatrica& a) const {
+    string putanja = privremenaPutanja();
+    try {
+        DiskMatrica rez(pomnozi(a, putanja, budzetMemorije));
+        rez.privremena = true;
+        return rez;
+    } catch (const char*) {
+        // djelimicno zapisan rezultat se ne ostavlja na disku
+        error_code greska;
+        filesystem::remove(putanja, greska);
+        throw;
+    }
+}
@@ -0,0 +1,136 @@
+/// \file diskmatrica.h
+
+#ifndef DISKMATRICA_H
+#define DISKMATRICA_H
+#include <iostream>
+#include <string>
+#include "matrica.h"
+using namespace std;
+
+/** \class DiskMatrica
+* Matrica realnih brojeva koja se čuva u datoteci na disku, podijeljena na blokove (tile-ove).
+*
+* Služi za matrice koje su prevelike da bi se instancirale kao <code> Matrica(int, int) </code>.
+* Datoteka počinje zaglavljem <code> (redovi, kolone, blok) </code>, nakon čega slijede blokovi
+* formata <code> blok x blok </code> poredani red po red. Rubni blokovi su dopunjeni nulama.
+*
+* U memoriji se nikada ne drži više od nekoliko blokova istovremeno.
+*
+* Rezultati operatora * su privremene datoteke koje objekat posjeduje: datoteka se briše u destruktoru,
+* osim ukoliko je matrica zadržana ili preimenovana. Zato se objekat ne može kopirati, već samo premjestiti.
+* @see <code> DiskMatrica operator* (const DiskMatrica& a) const; </code>
+*/
+
+class DiskMatrica {
+    string putanja;
+    int redovi, kolone, blok;
+    int blokRedova, blokKolona;
+    bool privremena;
+
+    long long pozicijaBloka(int i, int j) const;
+    static string privremenaPutanja();
+
+    // varijante nad vec otvorenim tokom, da se datoteka ne otvara za svaki blok
+    void ucitajBlok(istream& ulaz, int i, int j, double* odrediste) const;
+    void zapisiBlok(ostream& izlaz, int i, int j, const double* izvor) const;
+public:
+
+/** \brief Memorijski budžet (u bajtovima) za množenje matrica na disku.
+*
+*   Podrazumijevana vrijednost je 256 MiB.
+*/
+    static size_t budzetMemorije;
+
+/**
+*  \brief Kreira novu nul-matricu na disku.
+*
+*  @param putanja Putanja datoteke koja će se kreirati (postojeća datoteka se prepisuje).
+*  @param redovi Broj redova matrice.
+*  @param kolone Broj kolona matrice.
+*  @param blok Dimenzija kvadratnog bloka.
+*  @throw exception Izuzetak se baca ukoliko se datoteka ne može kreirati.
+*/
+    DiskMatrica(const string& putanja, int redovi, int kolone, int blok);
+
+/** \brief Otvara postojeću matricu na disku.
+*
+*   @throw exception Izuzetak se baca ukoliko datoteka ne postoji ili joj je zaglavlje neispravno.
+*/
+    DiskMatrica(const string& putanja);
+
+    DiskMatrica(const DiskMatrica&) = delete;
+    DiskMatrica& operator= (const DiskMatrica&) = delete;
+
+/// Move konstruktor, preuzima i vlasništvo nad privremenom datotekom.
+    DiskMatrica(DiskMatrica&& r);
+
+/// Move operator dodjele; privremena datoteka koju objekat posjeduje se prvo briše.
+    DiskMatrica& operator= (DiskMatrica&& r);
+
+/// Destruktor briše datoteku privremene matrice.
+    ~DiskMatrica();
+
+/// Da li se datoteka briše zajedno s objektom.
+    bool jePrivremena() const { return privremena; }
+
+/// Datoteka ostaje na disku i nakon uništavanja objekta.
+    void zadrzi() { privremena = false; }
+
+/** \brief Premještanje datoteke na novu putanju, nakon čega matrica više nije privremena.
+*
+*   @throw exception Izuzetak se baca ukoliko se datoteka ne može premjestiti.
+*/
+    void preimenuj(const string& nova);
+
+    int brojRedova() const { return redovi; }
+    int brojKolona() const { return kolone; }
+    int dimenzijaBloka() const { return blok; }
+    const string& datoteka() const { return putanja; }
+
+/** \brief Najveća dimenzija bloka koju dozvoljava memorijski budžet.
+*
+*   Pri množenju je istovremeno u memoriji 5 blokova: trenutni i sljedeći (prefetch) blok
+*   obje matrice, te blok rezultata.
+*/
+    static int blokZaBudzet(size_t budzet);
+
+/// Čitanje bloka (i, j) u niz od <code> blok*blok </code> elemenata.
+    void ucitajBlok(int i, int j, double* odrediste) const;
+
+/// Upisivanje bloka (i, j) iz niza od <code> blok*blok </code> elemenata.
+    void zapisiBlok(int i, int j, const double* izvor);
+
+/// Zapisuje matricu iz memorije na disk, u blokovima zadate dimenzije.
+    static DiskMatrica izMatrice(const Matrica& m, const string& putanja, int blok);
+
+/// Kao <code> izMatrice </code>, ali u privremenu datoteku koju briše destruktor.
+    static DiskMatrica privremenaIzMatrice(const Matrica& m, int blok);
+
+/** \brief Učitava čitavu matricu u memoriju.
+*
+*   \warning Ima smisla samo za matrice koje staju u memoriju.
+*/
+    Matrica uMatricu() const;
+
+/** \brief Množenje matrica na disku, blok po blok.
+*
+*   Blok rezultata <code> C<sub>ij</sub> </code> se računa kao suma <code> A<sub>ik</sub> * B<sub>kj</sub> </code>.
+*   Dok se množi trenutni par blokova, sljedeći par se učitava s diska kao zadatak u
+*   <code> BazenNiti::globalni() </code>. Svaka datoteka se otvara samo jednom za cijelo množenje.
+*   @param a Desna matrica u izrazu, mora imati istu dimenziju bloka.
+*   @param putanja Putanja datoteke rezultata.
+*   @param budzet Memorijski budžet u bajtovima.
+*   @throw exception Izuzetak se baca ukoliko matrice nisu kompatibilne ili budžet nije dovoljan za 5 blokova.
+*/
+    DiskMatrica pomnozi(const DiskMatrica& a, const string& putanja, size_t budzet) const;
+
+/** \brief Operator * definisan za množenje matrica na disku.
+*
+*   Rezultat se zapisuje u privremenu datoteku, uz budžet <code> budzetMemorije </code>.
+*   Datoteka se briše zajedno s rezultatom, osim ukoliko se pozove \c zadrzi ili \c preimenuj.
+*   @see <code> DiskMatrica pomnozi(const DiskMatrica& a, const string& putanja, size_t budzet) const; </code>
+*/
+    DiskMatrica operator* (const DiskMatrica& a) const;
+};
+
+#endif // DISKMATRICA_H
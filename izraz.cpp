@@ -0,0 +1,364 @@
+/// \file izraz.cpp
+
+#include "izraz.h"
+#include "modularna.h"
+#include "diskmatrica.h"
+#include <cmath>
+#include <vector>
+#include <mutex>
+#include <exception>
+#include <filesystem>
+
+using namespace std;
+
+// cijene i rangovi ostaju konacni i ispod prioriteta paralelnih petlji (+beskonacno),
+// inace bi se rangovi izjednacili u inf, a inverzna pretekla dijelove petlje koju nit ceka
+static const double najvecaCijena = 1e300;
+
+/// Da li se inverzna matrica reda \c n računa LU rastavom, prema metodi i pragu iz profila.
+static bool mjesovitaInverzija(int n) {
+    return Matrica::metodaInverzije == mjesovita || (Matrica::pragMjesovite > 0 && n >= Matrica::pragMjesovite);
+}
+
+Cvor::Cvor(Matrica* m):
+    tip(ulazna), znak(0), stepen(1), faktor(1), modul(0), lijevi(nullptr), desni(nullptr), roditelj(nullptr),
+    vrijednost(m), disk(nullptr), naDisku(false), redovi(m->redovi), kolone(m->kolone), cijena(0), rang(0), preostalo(0),
+    desniPrvi(false) {}
+
+Cvor::Cvor(DiskMatrica* d):
+    tip(ulazna), znak(0), stepen(1), faktor(1), modul(0), lijevi(nullptr), desni(nullptr), roditelj(nullptr),
+    vrijednost(nullptr), disk(d), naDisku(true), redovi(d->brojRedova()), kolone(d->brojKolona()), cijena(0), rang(0),
+    preostalo(0), desniPrvi(false) {}
+
+Cvor::Cvor(char ime, int redovi, int kolone):
+    tip(promjenljiva), znak(ime), stepen(1), faktor(1), modul(0), lijevi(nullptr), desni(nullptr), roditelj(nullptr),
+    vrijednost(nullptr), disk(nullptr), naDisku(false), redovi(redovi), kolone(kolone), cijena(0), rang(0), preostalo(0), desniPrvi(false) {}
+
+Cvor::Cvor(Cvor* dijete, double faktor):
+    tip(skaliranje), znak('*'), stepen(1), faktor(faktor), modul(0), lijevi(dijete), desni(nullptr), roditelj(nullptr),
+    vrijednost(nullptr), disk(nullptr), naDisku(false), redovi(dijete->redovi), kolone(dijete->kolone), rang(0), preostalo(0), desniPrvi(false) {
+    this->cijena = (double)redovi * kolone;
+}
+
+Cvor::Cvor(tipCvora tip, Cvor* dijete, long long stepen, uint32_t modul):
+    tip(tip), znak('^'), stepen(stepen), faktor(1), modul(modul), lijevi(dijete), desni(nullptr), roditelj(nullptr),
+    vrijednost(nullptr), disk(nullptr), naDisku(false), redovi(dijete->redovi), kolone(dijete->kolone), rang(0), preostalo(0), desniPrvi(false) {
+    double n = dijete->redovi;
+    if (tip == transponovanje) {
+        this->redovi = dijete->kolone;
+        this->kolone = dijete->redovi;
+        this->cijena = n * kolone;
+    } else if (tip == stepenovanje) {
+        if (dijete->redovi != dijete->kolone) throw "Samo kvadratne matrice se mogu stepenovati!";
+        // kvadriranje (i eventualno mnozenje) za svaki bit eksponenta
+        this->cijena = 2 * n*n*n * ceil(log2(stepen + 1));
+    } else {
+        if (dijete->redovi != dijete->kolone) throw "Samo kvadratne matrice imaju odgovarajucu inverznu matricu!";
+        // adjungovana: n*n minora, svaki razvijen po kofaktorima u (n-1)! koraka
+        // (n-1)! prekoracuje opseg double-a vec za n oko 170
+        if (!mjesovitaInverzija(dijete->redovi)) this->cijena = min(n*n * tgamma(n), najvecaCijena);
+        // float LU i nekoliko double reziduala
+        else this->cijena = 8 * n*n*n;
+    }
+}
+
+Cvor::Cvor(char znak, Cvor* lijevi, Cvor* desni):
+    tip(binarna), znak(znak), stepen(1), faktor(1), modul(0), lijevi(lijevi), desni(desni), roditelj(nullptr),
+    vrijednost(nullptr), disk(nullptr), naDisku(false), redovi(lijevi->redovi), kolone(lijevi->kolone), rang(0), preostalo(0), desniPrvi(false) {
+    if (znak == '*') {
+        if (lijevi->kolone != desni->redovi) throw "Matrice nisu kompatibilne za mnozenje";
+        this->kolone = desni->kolone;
+        this->naDisku = lijevi->naDisku || desni->naDisku;
+        this->cijena = (double)redovi * kolone * lijevi->kolone;
+    } else {
+        if (lijevi->redovi != desni->redovi || lijevi->kolone != desni->kolone) {
+            if (znak == '+') throw "Matrice za sabiranje nisu odgovarajucih formata";
+            throw "Matrice za oduzimanje nisu odgovarajucih formata";
+        }
+        this->cijena = (double)redovi * kolone;
+    }
+}
+
+Cvor::~Cvor() {
+    delete lijevi;
+    delete desni;
+    delete vrijednost;
+    delete disk;
+}
+
+/// Da li čvor svoj rezultat upisuje u bafer lijevog djeteta (elementwise operacije).
+static bool uMjestu(const Cvor* c) {
+    return c->tip == skaliranje || (c->tip == binarna && c->znak != '*');
+}
+
+/// Učitavanje rezultata čvora s diska u memoriju, za operacije koje nemaju kernel na disku.
+static void uMemoriju(Cvor* c) {
+    if (!c->disk) return;
+    c->vrijednost = new Matrica(c->disk->uMatricu());
+    delete c->disk;
+    c->disk = nullptr;
+}
+
+/// Rezultat čvora kao matrica na disku; matrica iz memorije se zapisuje u privremenu datoteku.
+static DiskMatrica* naDisk(Cvor* c, int blok) {
+    if (!c->disk) {
+        c->disk = new DiskMatrica(DiskMatrica::privremenaIzMatrice(*c->vrijednost, blok));
+        delete c->vrijednost;
+        c->vrijednost = nullptr;
+    }
+    return c->disk;
+}
+
+/** \brief Izračunavanje jednog čvora iz već izračunatih vrijednosti djece.
+*
+*   Sabiranje, oduzimanje i množenje skalarom se izvršavaju u baferu lijevog djeteta,
+*   koji bi ionako bio oslobođen; ostali čvorovi alociraju novu matricu.
+*   Proizvodi s operandom na disku se računaju blok po blok u privremenu datoteku.
+*/
+static void izracunajCvor(Cvor* c) {
+    if (c->naDisku) {
+        int blok = c->lijevi->disk ? c->lijevi->disk->dimenzijaBloka() : c->desni->disk->dimenzijaBloka();
+        DiskMatrica* l = naDisk(c->lijevi, blok);
+        DiskMatrica* d = naDisk(c->desni, blok);
+        c->disk = new DiskMatrica((*l) * (*d));
+    } else {
+        uMemoriju(c->lijevi);
+        if (c->desni) uMemoriju(c->desni);
+        Matrica* l = c->lijevi->vrijednost;
+        Matrica* rez;
+        if (uMjestu(c)) {
+            rez = l;
+            c->lijevi->vrijednost = nullptr;
+            if (c->tip == skaliranje) *rez * c->faktor;
+            else if (c->znak == '+') *rez += *c->desni->vrijednost;
+            else *rez -= *c->desni->vrijednost;
+        } else if (c->tip == transponovanje) {
+            rez = new Matrica(l->transponovana());
+        } else if (c->tip == invertovanje) {
+            if (mjesovitaInverzija(c->redovi)) rez = new Matrica(l->inverznaMjesovita());
+            else rez = new Matrica(l->inverzna());
+        } else if (c->tip == stepenovanje && c->modul) {
+            rez = new Matrica((ModularnaMatrica(*l, c->modul)^c->stepen).uMatricu());
+        } else if (c->tip == stepenovanje) {
+            rez = new Matrica((*l)^c->stepen);
+        } else {
+            rez = new Matrica((*l) * (*c->desni->vrijednost));
+        }
+        c->vrijednost = rez;
+    }
+
+    // medjurezultati djece vise nisu potrebni; privremene datoteke se brisu s objektima
+    delete c->lijevi->vrijednost;
+    c->lijevi->vrijednost = nullptr;
+    delete c->lijevi->disk;
+    c->lijevi->disk = nullptr;
+    if (c->desni) {
+        delete c->desni->vrijednost;
+        c->desni->vrijednost = nullptr;
+        delete c->desni->disk;
+        c->desni->disk = nullptr;
+    }
+}
+
+/// Dodatna memorija koju kernel čvora zauzima dok radi, osim samog rezultata.
+static size_t privremenaKernela(const Cvor* c, bool stedljivo) {
+    size_t n2 = Matrica::velicina(c->redovi, c->redovi);
+    // baza, rezultat i proizvod u 32-bitnim ostacima, te ulaz pretvoren po modulu
+    if (c->tip == stepenovanje && c->modul) return 4 * (size_t)c->redovi * c->redovi * sizeof(uint32_t);
+    size_t mnozenje = 0;
+    if (!stedljivo && (c->tip == stepenovanje || (c->tip == binarna && c->znak == '*'))) {
+        int n = c->redovi;
+        bool kvadratne = c->tip == stepenovanje ||
+                         (c->lijevi->redovi == c->lijevi->kolone && c->desni->redovi == c->desni->kolone);
+        // strassen() na razini reda r drzi 8 kvadranata, 2 pomocne i p1..p6 dok rekurzija racuna p7,
+        // tj. 17 matrica reda r/2, pa se razine sabiraju do praga (oko (17/3) n^2, uz pokazivace redova).
+        // Morton: oba operanda i rezultat u Z rasporedu i radni niz, svaki po n^2 elemenata.
+        if (kvadratne && (n & (n-1)) == 0 && n >= Matrica::pragStrassena) {
+            if (Matrica::rasporedMnozenja == morton) mnozenje = 4 * n2;
+            else
+                for (int r=n; r>2 && r>=Matrica::pragStrassena; r/=2) mnozenje += 17 * Matrica::velicina(r/2, r/2);
+        }
+    }
+    if (c->tip == binarna && c->znak == '*') return mnozenje;
+    if (c->tip == stepenovanje) {
+        // jedna matrica po razini rekurzije operatora ^, plus medjuproizvod
+        size_t razina = 0;
+        for (long long s=c->stepen; s>1; s/=2) razina++;
+        return (razina + 1) * n2 + mnozenje;
+    }
+    if (c->tip == invertovanje) return (mjesovitaInverzija(c->redovi) ? 6 : 3) * n2;
+    return 0;
+}
+
+/// Dodatna memorija čvora: kernel, te operandi s diska koji se učitavaju u memoriju.
+static size_t privremena(const Cvor* c, bool stedljivo) {
+    // proizvod na disku drzi u memoriji samo nekoliko blokova
+    if (c->naDisku) return DiskMatrica::budzetMemorije;
+    size_t ucitano = 0;
+    if (c->lijevi->naDisku) ucitano += Matrica::velicina(c->lijevi->redovi, c->lijevi->kolone);
+    if (c->desni && c->desni->naDisku) ucitano += Matrica::velicina(c->desni->redovi, c->desni->kolone);
+    return privremenaKernela(c, stedljivo) + ucitano;
+}
+
+/// Memorija koju čvor alocira za svoj rezultat.
+static size_t rezultat(const Cvor* c) {
+    if (c->naDisku || uMjestu(c)) return 0;
+    return Matrica::velicina(c->redovi, c->kolone);
+}
+
+/// Memorija koju rezultat čvora drži nakon izračunavanja, ne računajući ulazne matrice.
+static size_t zadrzano(const Cvor* c) {
+    if (c->naDisku || c->tip == ulazna || c->tip == promjenljiva) return 0;
+    // operand s diska ucitan u memoriju postaje bafer rezultata
+    if (uMjestu(c)) return c->lijevi->naDisku ? Matrica::velicina(c->redovi, c->kolone) : zadrzano(c->lijevi);
+    return Matrica::velicina(c->redovi, c->kolone);
+}
+
+/** \brief Vršna dodatna memorija pri izračunavanju podstabla, uz najbolji redoslijed djece.
+*
+*   Kao kod dodjele registara (Sethi-Ullman): prvo se računa dijete čiji međurezultati zauzimaju
+*   više memorije, jer njegov rezultat onda kraće čeka na drugo dijete. Izbor se pamti u \c desniPrvi.
+*/
+static size_t potreba(Cvor* c, bool stedljivo) {
+    if (c->tip == ulazna || c->tip == promjenljiva) return 0;
+    size_t vlastita = privremena(c, stedljivo) + rezultat(c);
+    size_t a = potreba(c->lijevi, stedljivo), za = zadrzano(c->lijevi);
+    if (!c->desni) return max(a, za + vlastita);
+    size_t b = potreba(c->desni, stedljivo), zb = zadrzano(c->desni);
+    size_t lijeviPrvi = max(max(a, za + b), za + zb + vlastita);
+    size_t desniPrvi = max(max(b, zb + a), za + zb + vlastita);
+    c->desniPrvi = desniPrvi < lijeviPrvi;
+    return min(lijeviPrvi, desniPrvi);
+}
+
+static void sumiraj(const Cvor* c, size_t& ulazi, size_t& medjurezultati) {
+    if (c->tip == ulazna || c->tip == promjenljiva) {
+        if (!c->naDisku) ulazi += Matrica::velicina(c->redovi, c->kolone);
+        return;
+    }
+    medjurezultati += privremena(c, false) + rezultat(c);
+    sumiraj(c->lijevi, ulazi, medjurezultati);
+    if (c->desni) sumiraj(c->desni, ulazi, medjurezultati);
+}
+
+PlanMemorije planirajMemoriju(Cvor* korijen, size_t budzet) {
+    PlanMemorije plan;
+    plan.ulazi = 0;
+    size_t svi = 0;
+    sumiraj(korijen, plan.ulazi, svi);
+    // rezultat se premjesta iz korijena; samo rezultat na disku se ucitava u novu matricu
+    size_t ucitavanje = korijen->naDisku ? Matrica::velicina(korijen->redovi, korijen->kolone) : 0;
+    plan.gornjaGranica = plan.ulazi + svi + ucitavanje;
+    plan.vrsnaStedljivo = plan.ulazi + max(potreba(korijen, true), zadrzano(korijen) + ucitavanje);
+    plan.vrsna = plan.ulazi + max(potreba(korijen, false), zadrzano(korijen) + ucitavanje);
+
+    if (budzet == 0 || plan.gornjaGranica <= budzet) plan.nacin = paralelni;
+    else if (plan.vrsna <= budzet) plan.nacin = serijski;
+    else if (plan.vrsnaStedljivo <= budzet) {
+        plan.nacin = stedljivi;
+        // redoslijed djece mora odgovarati stedljivim kernelima
+        potreba(korijen, true);
+    } else throw "Izraz premasuje memorijski budzet!";
+    return plan;
+}
+
+/// Izračunavanje u pozivajućoj niti, redoslijedom koji je odredio plan memorije.
+static void izracunajSerijski(Cvor* c) {
+    if (c->tip == ulazna || c->tip == promjenljiva) return;
+    if (c->desni && c->desniPrvi) izracunajSerijski(c->desni);
+    izracunajSerijski(c->lijevi);
+    if (c->desni && !c->desniPrvi) izracunajSerijski(c->desni);
+    izracunajCvor(c);
+}
+
+/// Povezivanje roditelja, brojanje neizračunate djece i računanje ranga (top-down).
+static void pripremi(Cvor* c, Cvor* roditelj, vector<Cvor*>& spremni) {
+    c->roditelj = roditelj;
+    c->rang = min(c->cijena + (roditelj ? roditelj->rang : 0), najvecaCijena);
+    if (c->tip == promjenljiva) throw "Promjenljiva nema vrijednost!";
+    if (c->tip == ulazna) return;
+    int djece = 0;
+    if (c->lijevi->tip != ulazna && c->lijevi->tip != promjenljiva) djece++;
+    if (c->desni && c->desni->tip != ulazna && c->desni->tip != promjenljiva) djece++;
+    c->preostalo = djece;
+    if (djece == 0) spremni.push_back(c);
+    pripremi(c->lijevi, c, spremni);
+    if (c->desni) pripremi(c->desni, c, spremni);
+}
+
+/// Izračunavanje stabla do korijena; rezultat ostaje u <code> korijen->vrijednost </code> ili <code> korijen->disk </code>.
+static void izracunajStablo(Cvor* korijen, BazenNiti& bazen, PlanMemorije* planIzlaz) {
+    vector<Cvor*> spremni;
+    pripremi(korijen, nullptr, spremni);
+    PlanMemorije plan = planirajMemoriju(korijen, Matrica::budzetMemorije);
+    if (planIzlaz) *planIzlaz = plan;
+    if (korijen->tip == ulazna) return;
+
+    if (plan.nacin != paralelni) {
+        bool prije = Matrica::stedljivoMnozenje;
+        Matrica::stedljivoMnozenje = plan.nacin == stedljivi;
+        try {
+            izracunajSerijski(korijen);
+        } catch (...) {
+            Matrica::stedljivoMnozenje = prije;
+            throw;
+        }
+        Matrica::stedljivoMnozenje = prije;
+        return;
+    }
+
+    atomic<int> aktivni(0);
+    atomic<bool> gotovo(false);
+    exception_ptr greska;
+    mutex zakljucavanje;
+
+    function<void(Cvor*)> pokreni = [&](Cvor* c) {
+        aktivni++;
+        bazen.dodaj([&, c]() {
+            bool uspjeh = true;
+            if (!gotovo) {
+                try {
+                    izracunajCvor(c);
+                } catch (...) {
+                    // i bad_alloc se prenosi niti koja ceka, umjesto da zavrsi radnu nit
+                    lock_guard<mutex> l(zakljucavanje);
+                    if (!greska) greska = current_exception();
+                    uspjeh = false;
+                }
+            }
+            if (!uspjeh || c == korijen) gotovo = true;
+            else if (!gotovo && --c->roditelj->preostalo == 0) pokreni(c->roditelj);
+            aktivni--;
+        }, c->rang);
+    };
+    for (size_t i=0; i<spremni.size(); i++) pokreni(spremni[i]);
+
+    // ceka se i na zadatke koji su jos u toku, kako bi se stablo moglo sigurno obrisati
+    bazen.cekaj([&]() { return gotovo && aktivni == 0; });
+    if (greska) rethrow_exception(greska);
+}
+
+Matrica izracunajIzraz(Cvor* korijen, BazenNiti& bazen, PlanMemorije* plan) {
+    izracunajStablo(korijen, bazen, plan);
+    if (korijen->disk) return korijen->disk->uMatricu();
+    // rezultat se premjesta iz korijena, koji se ionako brise sa stablom
+    return Matrica(move(*korijen->vrijednost));
+}
+
+DiskMatrica izracunajIzrazNaDisk(Cvor* korijen, BazenNiti& bazen, const string& putanja) {
+    izracunajStablo(korijen, bazen, nullptr);
+    if (!korijen->disk) {
+        int blok = DiskMatrica::blokZaBudzet(DiskMatrica::budzetMemorije);
+        blok = min(blok, max(korijen->redovi, korijen->kolone));
+        return DiskMatrica::izMatrice(*korijen->vrijednost, putanja, blok);
+    }
+    if (korijen->disk->jePrivremena()) {
+        korijen->disk->preimenuj(putanja);
+        return DiskMatrica(putanja);
+    }
+    // korijen je ulazna datoteka, koja se ne smije premjestiti
+    error_code greska;
+    if (!filesystem::copy_file(korijen->disk->datoteka(), putanja, filesystem::copy_options::overwrite_existing, greska))
+        throw "Datoteka matrice se ne moze kopirati!";
+    return DiskMatrica(putanja);
+}
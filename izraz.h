@@ -0,0 +1,161 @@
+/// \file izraz.h
+
+#ifndef IZRAZ_H
+#define IZRAZ_H
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <string>
+#include "matrica.h"
+#include "bazen.h"
+using namespace std;
+
+class DiskMatrica;
+
+/// \typedef enum {ulazna, promjenljiva, skaliranje, binarna, stepenovanje, transponovanje, invertovanje} tipCvora;
+typedef enum {ulazna, promjenljiva, skaliranje, binarna, stepenovanje, transponovanje, invertovanje} tipCvora;
+
+/** \struct Cvor
+* Čvor stabla (DAG-a) izraza koji se dobija parsiranjem ulaza.
+*
+* Format rezultata svakog čvora poznat je već pri parsiranju, pa se greške formata
+* otkrivaju prije bilo kakvog računanja. Nezavisna podstabla (npr. operandi operacije \c +)
+* izračunavaju se paralelno.
+* @see <code> Matrica izracunajIzraz(Cvor* korijen, BazenNiti& bazen); </code>
+*/
+
+struct Cvor {
+    tipCvora tip;
+    char znak;
+    long long stepen;
+    double faktor;
+
+/// Modul kod modularnog stepenovanja (<em> ^k mod p </em>), odnosno 0 za realnu aritmetiku.
+    uint32_t modul;
+    Cvor *lijevi, *desni, *roditelj;
+
+/// Ulazna matrica kod lista, odnosno rezultat čvora nakon izračunavanja.
+    Matrica* vrijednost;
+
+/// Ulazna matrica na disku kod lista, odnosno rezultat čvora ukoliko se čuva na disku.
+    DiskMatrica* disk;
+
+/** \brief Da li je rezultat čvora matrica na disku.
+*
+*   Tačno za listove na disku i za proizvode u kojima je bar jedan operand na disku; ostale operacije
+*   nad matricom s diska je prvo učitavaju u memoriju.
+*/
+    bool naDisku;
+
+    int redovi, kolone;
+
+/// Procjena broja operacija potrebnih za sam čvor (bez podstabala), ograničena na 10<sup>300</sup>.
+    double cijena;
+
+/// Najduži put od čvora do korijena, mjeren cijenom; duže grane se pokreću prve.
+    double rang;
+
+    atomic<int> preostalo;
+
+/// Da li se pri serijskom izračunavanju desno podstablo računa prije lijevog.
+    bool desniPrvi;
+
+/// List stabla, tj. matrica unesena u izraz.
+    Cvor(Matrica* m);
+
+/// List stabla čija je matrica na disku (<em> {putanja} </em> u izrazu); čvor postaje vlasnik objekta.
+    Cvor(DiskMatrica* d);
+
+/** \brief Promjenljiva (npr. \c A) poznatog formata, čija vrijednost nije dio izraza.
+*
+*   @see <code> class SerijskiIzraz; </code>
+*/
+    Cvor(char ime, int redovi, int kolone);
+
+/// Množenje matrice skalarom.
+    Cvor(Cvor* dijete, double faktor);
+
+/** \brief Unarne operacije: <em> ^k, ^T, ^-1 </em>, te <em> ^k mod p </em>.
+*
+*   @see <code> class ModularnaMatrica; </code>
+*/
+    Cvor(tipCvora tip, Cvor* dijete, long long stepen = 1, uint32_t modul = 0);
+
+/** \brief Binarna operacija među matricama.
+*
+*   @throw exception Izuzetak se baca ukoliko formati operanada nisu odgovarajući.
+*/
+    Cvor(char znak, Cvor* lijevi, Cvor* desni);
+
+/// Uništava čitavo podstablo i sve pridružene matrice.
+    ~Cvor();
+};
+
+/// \typedef enum {paralelni, serijski, stedljivi} nacinIzracunavanja;
+typedef enum {paralelni, serijski, stedljivi} nacinIzracunavanja;
+
+/** \struct PlanMemorije
+* Procjena memorije (u bajtovima) potrebne za izračunavanje izraza, prije samog izračunavanja.
+*/
+struct PlanMemorije {
+/// Ulazne matrice izraza.
+    size_t ulazi;
+/// Svi međurezultati istovremeno živi; granica za paralelno izračunavanje.
+    size_t gornjaGranica;
+/// Vršna memorija serijskog izračunavanja, s redoslijedom koji najranije oslobađa međurezultate.
+    size_t vrsna;
+/// Isto kao \c vrsna, ali bez Strassenovog množenja.
+    size_t vrsnaStedljivo;
+/// Izabrani način izračunavanja.
+    nacinIzracunavanja nacin;
+};
+
+/** \brief Planiranje memorije za izračunavanje stabla izraza.
+*
+*   Formati svih međurezultata poznati su iz stabla, pa se vršna memorija računa unaprijed, kao kod
+*   dodjele registara: međurezultat je živ od svog izračunavanja do izračunavanja roditelja, a
+*   sabiranje, oduzimanje i množenje skalarom ponovo koriste bafer lijevog operanda.
+*
+*   Ukoliko paralelno izračunavanje može premašiti budžet, bira se serijsko, a zatim serijsko bez
+*   Strassenovog množenja.
+*   @param budzet Budžet u bajtovima, 0 znači bez ograničenja.
+*   @throw exception Izuzetak se baca ukoliko ni štedljivo izračunavanje ne staje u budžet.
+*/
+PlanMemorije planirajMemoriju(Cvor* korijen, size_t budzet);
+
+/** \brief Parsiranje izraza iz ulaznog toka u stablo, do kraja reda.
+*
+*   @param promjenljive Formati (redovi, kolone) dozvoljenih promjenljivih (velika slova osim \c E i \c I),
+*   ili \c nullptr ukoliko izraz ne smije sadržavati promjenljive.
+*   @return Korijen stabla izraza, kojeg briše pozivalac.
+*   @throw exception Izuzetak se baca pri sintaksnoj grešci ili neodgovarajućim formatima matrica.
+*   @see <code> friend istream& operator >> (istream& ulaz, Matrica& a); </code>
+*/
+Cvor* parsirajIzraz(istream& ulaz, const map<char, pair<int, int>>* promjenljive);
+
+/** \brief Paralelno izračunavanje stabla izraza.
+*
+*   Čvor se dodaje u bazen čim su izračunata sva njegova djeca, s prioritetom jednakim
+*   svom rangu, tako da se grane na kritičnom putu (stepenovanje, inverzna, množenje) pokreću prve.
+*   Međurezultati djece se oslobađaju čim roditelj bude izračunat, a rezultat se premješta iz korijena,
+*   pa se stablo poslije ne može ponovo izračunati.
+*
+*   Prije izračunavanja se pravi plan memorije prema <code> Matrica::budzetMemorije </code>.
+*   @see <code> PlanMemorije planirajMemoriju(Cvor* korijen, size_t budzet); </code>
+*   @param plan Ukoliko nije \c nullptr, upisuje se korišteni plan memorije.
+*   @throw exception Prvi izuzetak bačen pri izračunavanju nekog čvora, odnosno ukoliko stablo sadrži
+*   promjenljive ili premašuje memorijski budžet.
+*/
+Matrica izracunajIzraz(Cvor* korijen, BazenNiti& bazen, PlanMemorije* plan = nullptr);
+
+/** \brief Izračunavanje stabla izraza u matricu na disku.
+*
+*   Za izraze čiji rezultat ne staje u memoriju, npr. <code> {a.blk} * {b.blk} * {c.blk} </code>:
+*   proizvodi s operandima na disku se računaju blok po blok, a međurezultati su privremene datoteke
+*   koje se brišu čim ih roditelj iskoristi.
+*   @param putanja Putanja datoteke rezultata.
+*   @throw exception Izuzetak kao kod <code> Matrica izracunajIzraz(Cvor* korijen, BazenNiti& bazen, PlanMemorije* plan); </code>
+*/
+DiskMatrica izracunajIzrazNaDisk(Cvor* korijen, BazenNiti& bazen, const string& putanja);
+
+#endif // IZRAZ_H
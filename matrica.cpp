@@ -1,13 +1,48 @@
 /// \file matrica.cpp
 
 #include "matrica.h"
+#include "izraz.h"
+#include "bazen.h"
+#include "diskmatrica.h"
 #include <iostream>
 #include <cmath>
 #include <stack>
 #include <iomanip>
+#include <map>
+#include <climits>
+#include <vector>
 
 using namespace std;
 
+raspored Matrica::rasporedMnozenja = redovni;
+metodaInverzne Matrica::metodaInverzije = kofaktori;
+size_t Matrica::budzetMemorije = 0;
+thread_local bool Matrica::stedljivoMnozenje = false;
+atomic<long long> Matrica::zauzeto(0);
+atomic<long long> Matrica::vrsno(0);
+
+long long Matrica::velicina(int redovi, int kolone) {
+    return (long long)redovi * kolone * sizeof(double) + (long long)redovi * sizeof(double*);
+}
+
+void Matrica::evidentiraj(long long bajtova) {
+    long long sada = (zauzeto += bajtova);
+    long long vrh = vrsno;
+    while (sada > vrh && !vrsno.compare_exchange_weak(vrh, sada));
+}
+
+size_t Matrica::zauzetaMemorija() {
+    return zauzeto;
+}
+
+size_t Matrica::vrsnaMemorija() {
+    return vrsno;
+}
+
+void Matrica::ponistiVrsnuMemoriju() {
+    vrsno = zauzeto.load();
+}
+
 /** \brief Prioritet binarne operacije.
 *
 *   @return Prioritet operacije, 0 u slučaju nepoznatog znaka.
@@ -18,24 +53,34 @@ int prioritetOperacije(char znak) {
     else return 0;
 }
 
-Matrica::Matrica() {
-    this->redovi = 3;
-    this->kolone = 3;
-    this->matrica = new double*[this->redovi];
-    for (int i =0; i<redovi; i++) {
-        this->matrica[i] = new double[this->kolone];
+void Matrica::alociraj(int redovi, int kolone) {
+    this->redovi = redovi;
+    this->kolone = kolone;
+    this->matrica = new double*[redovi];
+    for (int i=0; i<redovi; i++) {
+        this->matrica[i] = new double[kolone];
     }
+    evidentiraj(velicina(redovi, kolone));
+}
 
+void Matrica::oslobodi() {
+    for (int i=0; i<this->redovi; i++) delete [] this->matrica[i];
+    delete [] this->matrica;
+    evidentiraj(-velicina(this->redovi, this->kolone));
+    this->matrica = nullptr;
+    this->redovi = 0;
+    this->kolone = 0;
+}
+
+Matrica::Matrica() {
+    alociraj(3, 3);
     for (int i=0; i<redovi; i++) {
         for (int j=0; j<kolone; j++) matrica[i][j] = 0;
     }
 }
 
-Matrica::Matrica(int red): redovi(red), kolone(red) {
-    this->matrica = new double*[red];
-    for (int i =0; i<red; i++) {
-        this->matrica[i] = new double[this->kolone];
-    }
+Matrica::Matrica(int red) {
+    alociraj(red, red);
     for (int i=0; i<red; i++) {
         for (int j=0; j<red; j++) {
             if (i == j) {
@@ -47,23 +92,19 @@ Matrica::Matrica(int red): redovi(red), kolone(red) {
     }
 }
 
-Matrica::Matrica(int redovi, int kolone): redovi(redovi), kolone(kolone) {
-    this->matrica = new double*[redovi];
-    for (int i =0; i<redovi; i++) {
-        this->matrica[i] = new double[kolone];
-    }
+Matrica::Matrica(int redovi, int kolone) {
+    alociraj(redovi, kolone);
     for (int i=0; i<redovi; i++) {
         for (int j=0; j<kolone; j++) matrica[i][j] = 0;
     }
 }
 
+Matrica::Matrica(int redovi, int kolone, neinicijalizovana_t) {
+    alociraj(redovi, kolone);
+}
+
 Matrica::Matrica(const Matrica& r) {
-    this->redovi = r.redovi;
-    this->kolone = r.kolone;
-    this->matrica = new double*[redovi];
-    for (int i=0; i<this->redovi; i++) {
-        this->matrica[i] = new double[kolone];
-    }
+    alociraj(r.redovi, r.kolone);
     for (int i=0; i<this->redovi; i++)
         for (int j=0; j<this->kolone; j++)
             this->matrica[i][j] = r.matrica[i][j];
@@ -71,18 +112,11 @@ Matrica::Matrica(const Matrica& r) {
 
 Matrica& Matrica::operator=(Matrica& r) {
     if (this != &r) {
-        for (int i=0; i<this->redovi; i++) {
-            delete [] this->matrica[i];
-        }
-        delete [] this->matrica;
-
-        this->redovi = r.redovi;
-        this->kolone = r.kolone;
-        this->matrica = new double*[this->redovi];
-        for (int i=0; i<this->redovi; i++) {
-            this->matrica[i] = new double[this->kolone];
+        // isti format: elementi se prepisuju u postojece redove
+        if (this->redovi != r.redovi || this->kolone != r.kolone) {
+            oslobodi();
+            alociraj(r.redovi, r.kolone);
         }
-
         for (int i=0; i<this->redovi; i++)
             for (int j=0; j<this->kolone; j++)
                 this->matrica[i][j] = r.matrica[i][j];
@@ -90,40 +124,19 @@ Matrica& Matrica::operator=(Matrica& r) {
     return *this;
 }
 
-Matrica::Matrica(Matrica&& r) {
-    this->redovi = r.redovi;
-    this->kolone = r.kolone;
-    this->matrica = new double*[redovi];
-    for (int i=0; i<this->redovi; i++) {
-        this->matrica[i] = new double[kolone];
-    }
-    for (int i=0; i<this->redovi; i++)
-        for (int j=0; j<this->kolone; j++)
-            this->matrica[i][j] = r.matrica[i][j];
-
-    for (int i=0; i<r.redovi; i++) r.matrica[i] = nullptr;
+Matrica::Matrica(Matrica&& r): redovi(r.redovi), kolone(r.kolone), matrica(r.matrica) {
     r.matrica = nullptr;
+    r.redovi = 0;
+    r.kolone = 0;
 }
 
 
 Matrica& Matrica::operator=(Matrica&& r) {
     if (this != &r) {
-        for (int i=0; i<this->redovi; i++) {
-            delete [] this->matrica[i];
-        }
-        delete [] this->matrica;
-
+        oslobodi();
         this->redovi = r.redovi;
         this->kolone = r.kolone;
-        this->matrica = new double*[this->redovi];
-        for (int i=0; i<this->redovi; i++) {
-            this->matrica[i] = new double[this->kolone];
-        }
-        for (int i=0; i<this->redovi; i++)
-            for (int j=0; j<this->kolone; j++)
-                this->matrica[i][j] = r.matrica[i][j];
-
-        for (int i=0; i<r.redovi; i++) r.matrica[i] = nullptr;
+        this->matrica = r.matrica;
         r.matrica = nullptr;
         r.redovi = 0;
         r.kolone = 0;
@@ -132,8 +145,7 @@ Matrica& Matrica::operator=(Matrica&& r) {
 }
 
 Matrica::~Matrica() {
-    for (int i=0; i<this->redovi; i++) delete [] this->matrica[i];
-    delete [] matrica;
+    oslobodi();
 }
 
 
@@ -141,7 +153,7 @@ Matrica Matrica::submatrica(int red, int kol) {
     if (red > this->redovi || kol > this->kolone)
         throw "Ilegalni parametri za submatricu!";
 
-    Matrica* sub = new Matrica(this->redovi-1, this->kolone-1);
+    Matrica sub(this->redovi-1, this->kolone-1, neinicijalizovana);
     bool desno = false;
     bool dolje = false;
     for (int i=0; i<this->redovi; i++) {
@@ -154,58 +166,85 @@ Matrica Matrica::submatrica(int red, int kol) {
                 desno = true;
                 continue;
             }
-            sub->matrica[i-(int)dolje][j-(int)desno] = this->matrica[i][j];
+            sub.matrica[i-(int)dolje][j-(int)desno] = this->matrica[i][j];
         }
         desno = false;
     }
-    return *sub;
+    return sub;
 }
 
 
 // sabiranje matrica
-Matrica& Matrica::operator+ (const Matrica& a) {
+Matrica Matrica::operator+ (const Matrica& a) {
     if (this->redovi != a.redovi || this->kolone != a.kolone)
         throw "Matrice za sabiranje nisu odgovarajucih formata";
-    Matrica* rez = new Matrica(this->redovi, this->kolone);
+    Matrica rez(this->redovi, this->kolone, neinicijalizovana);
 
     for (int i=0; i<this->redovi; i++)
         for (int j=0; j<this->kolone; j++)
-            rez->matrica[i][j] = this->matrica[i][j] + a.matrica[i][j];
+            rez.matrica[i][j] = this->matrica[i][j] + a.matrica[i][j];
+
+    return rez;
+}
 
-    return *rez;
+// sabiranje u mjestu
+Matrica& Matrica::operator+= (const Matrica& a) {
+    if (this->redovi != a.redovi || this->kolone != a.kolone)
+        throw "Matrice za sabiranje nisu odgovarajucih formata";
+    for (int i=0; i<this->redovi; i++)
+        for (int j=0; j<this->kolone; j++)
+            this->matrica[i][j] += a.matrica[i][j];
+    return *this;
 }
 
 // oduzimanje matrica
-Matrica& Matrica::operator- (Matrica a) {
+Matrica Matrica::operator- (Matrica a) {
     if (this->redovi != a.redovi || this->kolone != a.kolone)
         throw "Matrice za oduzimanje nisu odgovarajucih formata";
-    Matrica* rez = new Matrica(this->redovi, this->kolone);
     a = a*(-1);
-    *rez = *this + a;
 //    for (int i=0; i<this->redovi; i++)
 //        for (int j=0; j<this->kolone; j++)
 //            rez->matrica[i][j] = this->matrica[i][j] + a.matrica[i][j];
 
-    return *rez;
+    return *this + a;
+}
+
+// oduzimanje u mjestu
+Matrica& Matrica::operator-= (const Matrica& a) {
+    if (this->redovi != a.redovi || this->kolone != a.kolone)
+        throw "Matrice za oduzimanje nisu odgovarajucih formata";
+    for (int i=0; i<this->redovi; i++)
+        for (int j=0; j<this->kolone; j++)
+            this->matrica[i][j] -= a.matrica[i][j];
+    return *this;
 }
 
 // mnozenje matrica
 Matrica Matrica::operator* (Matrica& a) {
     if (this->kolone != a.redovi)
         throw "Matrice nisu kompatibilne za mnozenje";
-    Matrica* rez = new Matrica(this->redovi, a.kolone);
-    if (a.redovi == a.kolone && this->redovi == this->kolone) {
+    // Strassen trosi dodatnu memoriju za kvadrante, pa se u stedljivom nacinu preskace
+    if (!stedljivoMnozenje && a.redovi == a.kolone && this->redovi == this->kolone && a.redovi >= pragStrassena) {
         int red = a.redovi;
         if ((log2(red) - trunc(log2(red))) == 0) {
-            *rez = strassen(*this, a, red);
-            return *rez;
+            if (rasporedMnozenja == morton) return strassenMorton(*this, a, red);
+            return strassen(*this, a, red);
         }
     }
-    for (int i=0; i<rez->redovi; i++)
-        for (int j=0; j<rez->kolone; j++)
-            for (int k=0; k<this->kolone; k++)
-                rez->matrica[i][j] += this->matrica[i][k] * a.matrica[k][j];
-    return *rez;
+    Matrica rez(this->redovi, a.kolone, neinicijalizovana);
+    auto redovi = [this, &a, &rez](int od, int doK) {
+        for (int i=od; i<doK; i++)
+            for (int j=0; j<rez.kolone; j++) {
+                double suma = 0;
+                for (int k=0; k<this->kolone; k++)
+                    suma += this->matrica[i][k] * a.matrica[k][j];
+                rez.matrica[i][j] = suma;
+            }
+    };
+    // mala mnozenja se ne isplati dijeliti na niti
+    if ((double)rez.redovi * rez.kolone * this->kolone < pragParalelnog) redovi(0, rez.redovi);
+    else BazenNiti::globalni().paralelno(0, rez.redovi, redovi);
+    return rez;
 }
 
 // mnozenje matrice skalarom
@@ -225,18 +264,11 @@ Matrica& operator* (double skalar, Matrica& a) {
 
 // brzo stepenovanje
 Matrica Matrica::operator^ (int stepen) {
-    static Matrica reff(*this);
-    if (stepen == 1) return reff;
-    Matrica* p = new Matrica(this->redovi, this->kolone);
-    if (stepen%2 == 0) {
-        *p = (this->operator^(stepen/2));
-        *p = (*p * *p);
-    } else {
-        *p = this->operator^(stepen/2);
-        *p = *p * *p;
-        *p = *p * reff;
-    }
-    return *p;
+    if (stepen == 1) return *this;
+    Matrica p(this->operator^(stepen/2));
+    p = p * p;
+    if (stepen%2 != 0) p = p * *this;
+    return p;
 }
 
 double Matrica::determinanta() {
@@ -264,26 +296,29 @@ bool Matrica::regularna() {
 }
 
 Matrica Matrica::transponovana() {
-    Matrica* transp = new Matrica(this->kolone, this->redovi);
-    for (int i=0; i<this->redovi; i++)
-        for (int j=0; j<this->kolone; j++)
-            transp->matrica[j][i] = this->matrica[i][j];
-
-    return *transp;
+    const int blok = blokTransponovanja;
+    Matrica transp(this->kolone, this->redovi, neinicijalizovana);
+    for (int bi=0; bi<this->redovi; bi+=blok)
+        for (int bj=0; bj<this->kolone; bj+=blok)
+            for (int i=bi; i<bi+blok && i<this->redovi; i++)
+                for (int j=bj; j<bj+blok && j<this->kolone; j++)
+                    transp.matrica[j][i] = this->matrica[i][j];
+
+    return transp;
 }
 
 Matrica Matrica::adjungovana() {
     if (this->redovi != this->kolone)
         throw "Matrica nema odgovarajucu adjungovanu";
 
-    Matrica* adj = new Matrica(this->redovi, this->kolone);
+    Matrica adj(this->redovi, this->kolone, neinicijalizovana);
     for (int i=0; i<this->redovi; i++) {
         for (int j=0; j<this->kolone; j++) {
-            Matrica* minor = new Matrica(this->submatrica(i, j));
-            adj->matrica[j][i] = pow(-1, i+j) * minor->determinanta();
+            Matrica minor(this->submatrica(i, j));
+            adj.matrica[j][i] = pow(-1, i+j) * minor.determinanta();
         }
     }
-    return *adj;
+    return adj;
 }
 
 Matrica Matrica::inverzna() {
@@ -309,7 +344,7 @@ ostream& operator << (ostream& izlaz, const Matrica& a)  {
         return izlaz;
 }
 
-void izvrsiBinarnuOperaciju(stack<Matrica*>& matrice, stack<char>& operacije, stack<st>& op, stack<double>& skalari) {
+void izvrsiBinarnuOperaciju(stack<Cvor*>& matrice, stack<char>& operacije, stack<st>& op, stack<double>& skalari) {
     if (matrice.size() < 1) throw "Nedostaje matrica!";
     if (operacije.empty()) throw "Nedostaje operacija!";
     if (op.size() < 2) throw "Nedostaju operandi!";
@@ -318,7 +353,6 @@ void izvrsiBinarnuOperaciju(stack<Matrica*>& matrice, stack<char>& operacije, st
     op.pop();
     st op1 = op.top();
     op.pop();
-    Matrica* rez = new Matrica;
     char znak = operacije.top();
     operacije.pop();
     // jedna matrica i jedan skalar
@@ -327,31 +361,24 @@ void izvrsiBinarnuOperaciju(stack<Matrica*>& matrice, stack<char>& operacije, st
         if (prioritetOperacije(znak) != 2) throw "Ne mogu se sabirati matrica i skalar";
         double broj = skalari.top();
         skalari.pop();
-        Matrica* m = matrice.top();
-        matrice.pop();
-        *rez = (*m * broj);
         op.push(matrica);
-        matrice.push(rez);
+        // operand se zamjenjuje tek kad je cvor napravljen, pa pri izuzetku ostaje na steku
+        matrice.top() = new Cvor(matrice.top(), broj);
     } // dvije matrice
     else if (op1 == matrica && op2 == matrica) {
-        Matrica* d = matrice.top();
-        matrice.pop();
-        Matrica* l = matrice.top();
-        matrice.pop();
-        if (znak == '+') {
-            rez = new Matrica(l->redovi, l->kolone);
-            *rez = *l + *d;
-        } else if (znak == '-') {
-            rez = new Matrica(l->redovi, l->kolone);
-            *rez = *l - *d;
-        } else if (znak == '*') {
-            rez = new Matrica(l->redovi, d->kolone);
-            *rez = (*l) * (*d);
-        } else {
+        if (matrice.size() < 2) throw "Nedostaje matrica!";
+        if (znak != '+' && znak != '-' && znak != '*')
             throw "Do ove greske nece nikada doci!";
-        }
+        Cvor* d = matrice.top();
+        matrice.pop();
         op.push(matrica);
-        matrice.push(rez);
+        // ukoliko formati ne odgovaraju, desni operand se vraca na stek da bi ga parser obrisao
+        try {
+            matrice.top() = new Cvor(znak, matrice.top(), d);
+        } catch (...) {
+            matrice.push(d);
+            throw;
+        }
     } // dva skalara
     else if (op1 == skalar && op2 == skalar) {
         if (skalari.empty()) throw "Nedostaje skalar!";
@@ -372,16 +399,16 @@ void izvrsiBinarnuOperaciju(stack<Matrica*>& matrice, stack<char>& operacije, st
     }
 }
 
-Matrica* Matrica::ucitajMatricu() {
-    double* niz = new double[4000];
-    int br_kol(0), red(1), prva_kol, poz(0);
-    while (cin.peek() != ']') {
-        if (cin.peek() >= '0' && cin.peek() <= '9' || cin.peek() == '-') {
+Matrica* Matrica::ucitajMatricu(istream& ulaz) {
+    vector<double> niz;
+    int br_kol(0), red(1), prva_kol(0);
+    while (ulaz.peek() != ']') {
+        if (ulaz.peek() >= '0' && ulaz.peek() <= '9' || ulaz.peek() == '-') {
             double br;
-            cin >> br;
-            niz[poz++] = br;
+            ulaz >> br;
+            niz.push_back(br);
             br_kol++;
-        } else if (cin.peek() == ';') {
+        } else if (ulaz.peek() == ';') {
             if (red == 1) {
                 prva_kol = br_kol;
             } else {
@@ -389,67 +416,93 @@ Matrica* Matrica::ucitajMatricu() {
             }
             red++;
             br_kol = 0;
-            cin.get();
-        } else if (cin.peek() == ' '){
-            cin.get();
+            ulaz.get();
+        } else if (ulaz.peek() == ' '){
+            ulaz.get();
         } else
             throw "Neocekivan znak!";
     }
-    Matrica* rez = new Matrica(red, br_kol);
-    double* p = niz;
+    // svaki element mora biti ucitan, jer se matrica ne popunjava nulama
+    if (red > 1 && prva_kol != br_kol) throw "Grbave matrice nisu podrzane!";
+    Matrica* rez = new Matrica(red, br_kol, neinicijalizovana);
+    const double* p = niz.data();
     for (int i=0; i<red; i++) {
         for (int j=0; j<br_kol; j++) {
             rez->matrica[i][j] = *p; p++;
         }
     }
-    delete [] niz;
     return rez;
 }
 
-istream& operator >> (istream& ulaz, Matrica& a) {
+static void parsirajNaStek(istream& ulaz, const map<char, pair<int, int>>* promjenljive, stack<Cvor*>& matrice) {
     st prethodni(otvorenaZ);
-    stack<Matrica*> matrice;
     stack<char> znakovi;
     stack<st> operandi;
     stack<double> rBrojevi;
-    while (ulaz.peek() != '\n') {
+    while (ulaz.peek() != '\n' && ulaz.peek() != EOF) {
         while (ulaz.peek() == ' ') ulaz.get();
         if (ulaz.peek() == '[') {
             ulaz.get();
-            Matrica* nova = a.ucitajMatricu();
-            matrice.push(nova);
+            Matrica* nova = Matrica::ucitajMatricu(ulaz);
+            matrice.push(new Cvor(nova));
             ulaz.get();
             operandi.push(matrica);
             prethodni = matrica;
+        } // matrica na disku: {putanja}
+        else if (ulaz.peek() == '{') {
+            if (prethodni == matrica || prethodni == zatvorenaZ || prethodni == skalar) throw "Fali operacija!";
+            ulaz.get();
+            string putanja;
+            while (ulaz.peek() != '}') {
+                if (ulaz.peek() == '\n' || ulaz.peek() == EOF) throw "Fali zatvorena viticasta zagrada!";
+                putanja += (char)ulaz.get();
+            }
+            ulaz.get();
+            matrice.push(new Cvor(new DiskMatrica(putanja)));
+            operandi.push(matrica);
+            prethodni = matrica;
         }
         else if (ulaz.peek() == '^') {
             if (prethodni == skalar) throw "Stepenovanje skalara!";
             if (prethodni == otvorenaZ) throw "Fali matrica!";
             if (prethodni == operacija) throw "Stepen poslije operacije!";
+            if (matrice.empty()) throw "Fali matrica!";
             ulaz.get();
-            Matrica* n = new Matrica(*matrice.top());
-            matrice.pop();
+            // n ostaje na steku dok ga novi cvor ne preuzme, da bi se obrisao ako parsiranje ne uspije
+            Cvor* n = matrice.top();
             if (ulaz.peek() == 'T') {
                 ulaz.get();
-                *n = n->transponovana();
-                matrice.push(n);
+                matrice.top() = new Cvor(transponovanje, n);
+                continue;
+            }
+            long long stepen;
+            ulaz >> stepen;
+            if (!ulaz) throw "Neispravan argument!";
+            // modularno stepenovanje: ^k mod p
+            while (ulaz.peek() == ' ') ulaz.get();
+            if (ulaz.peek() == 'm') {
+                char rijec[3];
+                ulaz.read(rijec, 3);
+                if (!ulaz || rijec[1] != 'o' || rijec[2] != 'd') throw "Neocekivan znak!";
+                long long modul;
+                ulaz >> modul;
+                if (!ulaz || modul < 2 || modul >= (1ll << 31)) throw "Modul mora biti izmedju 2 i 2^31!";
+                if (stepen < 0) throw "Neispravan argument!";
+                matrice.top() = new Cvor(stepenovanje, n, stepen, (uint32_t)modul);
+                prethodni = matrica;
                 continue;
             }
-            int stepen;
-            cin >> stepen;
-            if (stepen < -1 || stepen == 0) throw "Neispravan argument!";
+            if (stepen < -1 || stepen == 0 || stepen > INT_MAX) throw "Neispravan argument!";
             if (stepen == -1) {
-                *n = n->inverzna();
-                matrice.push(n);
+                matrice.top() = new Cvor(invertovanje, n);
             } else {
-                *n = (*n)^stepen;
-                matrice.push(n);
+                matrice.top() = new Cvor(stepenovanje, n, stepen);
             }
             prethodni = matrica;
         } else if (ulaz.peek() >= '0' && ulaz.peek() <= '9') {
             if (prethodni == matrica || prethodni == zatvorenaZ) throw "Fali operacija!";
             double broj;
-            cin >> broj;
+            ulaz >> broj;
             prethodni = skalar;
             rBrojevi.push(broj);
             operandi.push(skalar);
@@ -477,12 +530,20 @@ istream& operator >> (istream& ulaz, Matrica& a) {
             ulaz.get();
             if (ulaz.peek() >= '0' && ulaz.peek() <= '9') {
                 int red;
-                cin >> red;
+                ulaz >> red;
                 Matrica* jed = new Matrica(red);
-                matrice.push(jed);
+                matrice.push(new Cvor(jed));
                 prethodni = matrica;
                 operandi.push(matrica);
             } else throw "Mora se navesti red jedinicne matrice!";
+        } else if (promjenljive && ulaz.peek() >= 'A' && ulaz.peek() <= 'Z') {
+            if (prethodni == matrica || prethodni == zatvorenaZ || prethodni == skalar) throw "Fali operacija!";
+            char ime = ulaz.get();
+            auto format = promjenljive->find(ime);
+            if (format == promjenljive->end()) throw "Nepoznata promjenljiva!";
+            matrice.push(new Cvor(ime, format->second.first, format->second.second));
+            prethodni = matrica;
+            operandi.push(matrica);
         } else throw "Neocekivan znak!";
     }
 
@@ -490,7 +551,40 @@ istream& operator >> (istream& ulaz, Matrica& a) {
         if (znakovi.top() == '(') throw "Fali zatvorena zagrada!";
         izvrsiBinarnuOperaciju(matrice, znakovi, operandi, rBrojevi);
     }
-    a = (*matrice.top());
-    cin.ignore(10000, '\n');
+    if (matrice.empty()) throw "Rezultat izraza mora biti matrica!";
+}
+
+Cvor* parsirajIzraz(istream& ulaz, const map<char, pair<int, int>>* promjenljive) {
+    stack<Cvor*> matrice;
+    try {
+        parsirajNaStek(ulaz, promjenljive, matrice);
+    } catch (...) {
+        // cvorovi na steku jos nisu dio nijednog stabla
+        while (!matrice.empty()) {
+            delete matrice.top();
+            matrice.pop();
+        }
+        throw;
+    }
+    Cvor* korijen = matrice.top();
+    matrice.pop();
+    while (!matrice.empty()) {
+        delete matrice.top();
+        matrice.pop();
+    }
+    return korijen;
+}
+
+istream& operator >> (istream& ulaz, Matrica& a) {
+    Matrica::ponistiVrsnuMemoriju();
+    Cvor* korijen = parsirajIzraz(ulaz, nullptr);
+    try {
+        a = izracunajIzraz(korijen, BazenNiti::globalni());
+    } catch (...) {
+        delete korijen;
+        throw;
+    }
+    delete korijen;
+    ulaz.ignore(10000, '\n');
     return ulaz;
 }
@@ -4,11 +4,28 @@
 #define MATRICA_H
 #include <iostream>
 #include <stack>
+#include <atomic>
+#include <string>
 using namespace std;
 
 /// \typedef enum {matrica, otvorenaZ, zatvorenaZ, skalar, operacija} st;
 typedef enum {matrica, otvorenaZ, zatvorenaZ, skalar, operacija} st;
 
+/// \typedef enum {redovni, morton} raspored;
+typedef enum {redovni, morton} raspored;
+
+/// \typedef enum {kofaktori, mjesovita} metodaInverzne;
+typedef enum {kofaktori, mjesovita} metodaInverzne;
+
+struct Cvor;
+
+/** \struct neinicijalizovana_t
+* Oznaka za konstruktor koji ne popunjava elemente matrice.
+* @see <code> Matrica(int redovi, int kolone, neinicijalizovana_t); </code>
+*/
+struct neinicijalizovana_t {};
+constexpr neinicijalizovana_t neinicijalizovana{};
+
 /** \class Matrica
 * Ovo je klasa koja u sebi sadrži matricu realnih brojeva.
 *
@@ -24,8 +41,109 @@ typedef enum {matrica, otvorenaZ, zatvorenaZ, skalar, operacija} st;
 class Matrica {
     int redovi, kolone;
     double** matrica;
+
+    static atomic<long long> zauzeto, vrsno;
+    static void evidentiraj(long long bajtova);
+
+    void alociraj(int redovi, int kolone);
+    void oslobodi();
 public:
 
+/** \brief Raspored u kojem se izvršava brzo (Strassenovo) množenje.
+*
+*   Ukoliko je postavljen na \c morton, matrice se prije množenja prevode u Morton (Z) raspored,
+*   u kojem su kvadranti uzastopni blokovi memorije. Podrazumijevano je \c redovni.
+*   @see <code> friend Matrica strassenMorton(Matrica& l, Matrica& d, int red); </code>
+*/
+    static raspored rasporedMnozenja;
+
+/** \brief Dimenzija lista (bloka) u Morton rasporedu, stepen broja 2; podrazumijevano 32.
+*
+*   Unutar lista elementi su poredani red po red i množe se klasično, pa list treba da stane u keš.
+*/
+    static int listMortona;
+
+/** \brief Metoda kojom parser računa inverznu matricu (<em> ^-1 </em>).
+*
+*   Podrazumijevano je \c kofaktori, tj. <code> Matrica inverzna(); </code>
+*   @see <code> Matrica inverznaMjesovita(int* iteracije, bool* dvostruka); </code>
+*/
+    static metodaInverzne metodaInverzije;
+
+/** \brief Najmanji red matrice od kojeg parser računa inverznu LU rastavom, i kad je metoda \c kofaktori.
+*
+*   0 znači da se uvijek koristi \c metodaInverzije.
+*/
+    static int pragMjesovite;
+
+/** \brief Najmanji red matrica za Strassenovo množenje (red mora biti i stepen broja 2).
+*
+*   Prag važi i u rekurziji: podmatrice reda manjeg od praga se množe klasično, jer su
+*   rekurzivni pozivi i pomoćne matrice na malim redovima skuplji od uštede.
+*/
+    static int pragStrassena;
+
+/// Broj operacija (redovi * kolone * zajednička dimenzija) od kojeg se klasično množenje dijeli na niti.
+    static double pragParalelnog;
+
+/// Dimenzija bloka pri transponovanju.
+    static int blokTransponovanja;
+
+/** \brief Putanja profila podešavanja: varijabla okruženja \c MATRICA_PROFIL, inače \c matrica.profil.
+*
+*   Profil se učitava pri pokretanju programa, a pravi ga alat \c autotuner.
+*/
+    static string putanjaProfila();
+
+/** \brief Učitavanje profila podešavanja.
+*
+*   Profil je tekstualna datoteka s redovima <code> kljuc vrijednost </code>, a redovi koji počinju
+*   znakom \c # su komentari:
+*   \code
+*   strassen.prag 256
+*   mnozenje.raspored morton
+*   morton.list 64
+*   mnozenje.paralelno 200000
+*   transponovanje.blok 32
+*   inverzna.mjesovita 5
+*   bazen.niti 7
+*   \endcode
+*   Nepoznati ključevi i neispravne vrijednosti se zanemaruju, a nenavedeni parametri zadržavaju vrijednost.
+*   @return false ukoliko se datoteka ne može otvoriti.
+*/
+    static bool ucitajProfil(const string& putanja);
+
+/// Zapisivanje trenutnih parametara u profil podešavanja.
+    static bool zapisiProfil(const string& putanja);
+
+/** \brief Memorijski budžet (u bajtovima) za izračunavanje jednog izraza, 0 znači bez ograničenja.
+*
+*   @see <code> PlanMemorije planirajMemoriju(Cvor* korijen, size_t budzet); </code>
+*/
+    static size_t budzetMemorije;
+
+/** \brief Štedljivo množenje u trenutnoj niti.
+*
+*   Ukoliko je postavljeno, <code> Matrica operator* (Matrica& a); </code> ne koristi Strassenov algoritam,
+*   čiji kvadranti zauzimaju nekoliko puta više memorije od samog rezultata.
+*/
+    static thread_local bool stedljivoMnozenje;
+
+/// Broj bajtova koje zauzima matrica formata redovi x kolone (elementi i pokazivači na redove).
+    static long long velicina(int redovi, int kolone);
+
+/// Ukupna memorija koju trenutno zauzimaju sve instance klase Matrica, u bajtovima.
+    static size_t zauzetaMemorija();
+
+/// Najveća zauzeta memorija od posljednjeg poziva <code> static void ponistiVrsnuMemoriju(); </code>
+    static size_t vrsnaMemorija();
+
+/// Postavlja vršnu memoriju na trenutno zauzetu.
+    static void ponistiVrsnuMemoriju();
+
+/// Broj iteracija posljednjeg poziva <code> Matrica inverznaMjesovita(int* iteracije, bool* dvostruka); </code>
+    static atomic<int> posljednjeIteracije;
+
 /** \brief Konstruktor bez parametara.
 *   Dinamički alocira nul-matricu formata 3x3.
 */
@@ -44,16 +162,29 @@ public:
 */
     Matrica(int j, int k);
 
+/** \brief Konstruktor koji samo alocira matricu, bez upisivanja nula.
+*
+*   Koristi se kad će svi elementi ionako biti prepisani (rezultati operacija, učitavanje),
+*   čime se izbjegava jedan prolaz kroz čitavu memoriju matrice.
+*   \code
+*   Matrica t(kolone, redovi, neinicijalizovana);
+*   \endcode
+*/
+    Matrica(int redovi, int kolone, neinicijalizovana_t);
+
 /// Konstruktor kopije klase Matrica.
     Matrica(const Matrica& r);
 
-/// Operator dodjele klase Matrica.
+/** \brief Operator dodjele klase Matrica.
+*
+*   Ukoliko su matrice istog formata, postojeća memorija se ponovo koristi bez realokacije.
+*/
     Matrica& operator= (Matrica& r);
 
-/// Move konstruktor klase Matrica.
+/// Move konstruktor klase Matrica, preuzima memoriju matrice \c r, koja ostaje prazna (0x0).
     Matrica(Matrica&& r);
 
-/// Move operator dodjele klase Matrica.
+/// Move operator dodjele klase Matrica, oslobađa postojeću memoriju i preuzima memoriju matrice \c r.
     Matrica& operator= (Matrica&& r);
 
 /// \brief Destruktor klase Matrica.
@@ -69,13 +200,19 @@ public:
 *
 *   Ukoliko matrice nisu istog formata, funkcija baca izuzetak.
 */
-    Matrica& operator+ (const Matrica& a);
+    Matrica operator+ (const Matrica& a);
+
+/// Sabiranje u mjestu, bez alokacije nove matrice.
+    Matrica& operator+= (const Matrica& a);
 
 /** \brief Oduzimanje matrica.
 *
 *   Ukoliko matrice nisu istog formata, funkcija baca izuzetak.
 */
-    Matrica& operator- (Matrica a);
+    Matrica operator- (Matrica a);
+
+/// Oduzimanje u mjestu, bez alokacije nove matrice.
+    Matrica& operator-= (const Matrica& a);
 
 /** \brief Operator * definisan za množenje matrica.
 *
@@ -83,17 +220,24 @@ public:
 *   funkcija baca izuzetak.
 *
 *   Ukoliko su matrice istog formata, kvadratne, i reda koji je stepen broja 2, poziva se funkcija brzog množenja
-*   matrica
+*   matrica. Klasično množenje velikih matrica se dijeli po redovima na niti zajedničkog bazena.
 *   @see <code> friend Matrica strassen(Matrica& l, Matrica& d, int red); </code>
+*   @see <code> static raspored rasporedMnozenja; </code>
 *   @return Vraća se matrica koja ima redova koliko i prva matrica, a kolona kao druga matrica.
 */
     Matrica operator* (Matrica& a);
 
     friend Matrica strassen(Matrica& l, Matrica& d, int red);
 
+    friend double* uMorton(const Matrica& m, int red);
+    friend Matrica izMortona(const double* z, int red);
+    friend Matrica strassenMorton(Matrica& l, Matrica& d, int red);
+
 /** \brief Brzo stepenovanje matrica.
 *
 *   Funkcija se izvršava rekurzivno sve dok stepen ne dosegne 1, radi u vremenu O(log<sub>2</sub>n)
+*   Osnova stepena je uvijek matrica nad kojom je funkcija pozvana, pa se funkcija može pozivati
+*   i iz više niti istovremeno.
 *   @param stepen Stepen/eksponent izraza. Pri svakom rekurzivnom pozivu se polovi.
 *   @throw exception Funkcija baca izuzetak ukoliko matrica nije formata nxn.
 */
@@ -143,9 +287,20 @@ public:
 /** \brief Transponovana matrica.
 *
 *   Funkcija koja vraća transponovanu matricu, tj gdje vrijedi <code>A<sub>ij</sub> = A<sub>ji</sub></code>
+*
+*   Prepisivanje se vrši po blokovima, kako bi i čitanje i pisanje ostalo u kešu i za velike matrice.
+*   @see <code> friend Matrica transponovanaMorton(const Matrica& m, int red); </code>
 */
     Matrica transponovana();
 
+/** \brief Rekurzivno transponovanje kroz Morton raspored, za kvadratne matrice reda stepena broja 2.
+*
+*   Matrica se prevodi u Z raspored, transponuje <code> void transponujMorton(const double* z, double* t, int red); </code>
+*   i vraća u redovni raspored. Zbog dva prevođenja je sporije od <code> Matrica transponovana(); </code>,
+*   pa se koristi kada su podaci već u Z rasporedu; oba načina poredi alat \c alati/raspored.cpp.
+*/
+    friend Matrica transponovanaMorton(const Matrica& m, int red);
+
 /** \brief Inverzna matrica.
 *
 *   Funkcija vraća inverznu matricu kvadratne, regularne matrice. Računa se kao <code> 1/detA * adj(A)
@@ -153,16 +308,31 @@ public:
 */
     Matrica inverzna();
 
+/** \brief Inverzna matrica u mješovitoj preciznosti.
+*
+*   LU rastav s djelimičnim pivotiranjem se računa u \c float preciznosti (dvostruko manje memorije
+*   i dvostruko više elemenata po SIMD instrukciji), a rješenje <code> AX = I </code> se zatim
+*   iterativno popravlja: rezidual <code> R = I - AX </code> se računa u \c double preciznosti,
+*   a korekcija iz \c float rastava. Ukoliko se rezidual ne smanjuje (loše uslovljena matrica),
+*   inverzna se računa LU rastavom u \c double preciznosti.
+*
+*   @param iteracije Ukoliko nije \c nullptr, upisuje se broj iteracija popravljanja.
+*   @param dvostruka Ukoliko nije \c nullptr, upisuje se da li se moralo preći na \c double rastav.
+*   @throw exception Baca izuzetak ukoliko je matrica singularna ili nije kvadratna.
+*/
+    Matrica inverznaMjesovita(int* iteracije = nullptr, bool* dvostruka = nullptr);
+
 /** \brief Statička funkcija koja učitava matricu iz ulaznog toka.
 *
 *   Pri nailasku na znak '[' poziva se ova funkcija.
 *   @see <code> friend istream& operator >> (istream& ulaz, Matrica& a); </code>
 *
 *   Brojevi se izdvajaju iz ulaznog toka, jedan po jedan. Kraj reda se označava sa znakom ';'
+*   @param ulaz Ulazni tok iz kojeg se čita, podrazumijevano \c cin.
 *   @return Vraća pokazivač na novokreiranu instancu klase Matrica.
 *   @throw exception Izuzetak se baca ako je matrica grbava ili ako je unesen nepčekivan znak.
 */
-    static Matrica* ucitajMatricu();
+    static Matrica* ucitajMatricu(istream& ulaz = cin);
 
 /** \brief Množenje matrice skalarom
 *
@@ -177,18 +347,20 @@ public:
 *   \code typedef enum {matrica, otvorenaZ, zatvorenaZ, skalar, operacija} st; \endcode
 *   \warning Ovaj stack prima samo tipove <em> matrica, skalar </em>
 *
-*   Na osnovu datih kominacija ova 2 tipa računa se, i vraća rezultat na odgovarajući stack. (npr. matrica*matrica = matrica
-*   ili skalar*matrica = matrica).
+*   Na osnovu datih kominacija ova 2 tipa gradi se čvor stabla izraza i vraća na odgovarajući stack.
+*   (npr. matrica*matrica = matrica ili skalar*matrica = matrica). Same matrice se ne računaju ovdje,
+*   već tek kada je čitavo stablo izraza izgrađeno.
+*   @see <code> Matrica izracunajIzraz(Cvor* korijen, BazenNiti& bazen); </code>
 *
-*   Funkcija omogućava čak i isključivo operacije sa skalarima,
+*   Funkcija omogućava čak i isključivo operacije sa skalarima (one se računaju odmah),
 *   sve dok rezultat čitavog izraza nije skalar (tada dolazi do bacanja izuzetka).
-*   @param m Stack pokazivača na sve unesene matrice izraza.
+*   @param m Stack pokazivača na čvorove (podizraze) čiji je rezultat matrica.
 *   @param p Stack karaktera koji predstavljaju operacije.
 *   @param op Stack pobrojanih tipova \c st koji predstavljaju generičke operande.
 *   @param sk Stack svih unesenih skalara izraza.
 *   @throw exception Izuzetak se baca ukoliko neki stack nema dovoljno elemenata za rad funkcije.
 */
-    friend void izvrsiBinarnuOperaciju(stack<Matrica*>& m, stack<char>& o, stack<st>& op, stack<double>& sk);
+    friend void izvrsiBinarnuOperaciju(stack<Cvor*>& m, stack<char>& o, stack<st>& op, stack<double>& sk);
 
 /** \brief Ispisivanje matrice na izlazni tok.
 *
@@ -206,17 +378,35 @@ public:
 *   Koncept računanja izraza je čuvanje operanda na <code> stack<st> op </code>, pri čemu u stacku op
 *   je dozvoljeno čuvanje samo tip <em> matrica, skalar </em> iz \c st pobrojanog tipa.
 *   S tim je moguće utvrditi posljednja 2 operanda i samo pozivanje odgovarajućih funkcija implementiranih ranije:
-*   @see <code> friend void izvrsiBinarnuOperaciju(stack<Matrica*>& m, stack<char>& o, stack<st>& op, stack<double>& sk); </code>
+*   @see <code> friend void izvrsiBinarnuOperaciju(stack<Cvor*>& m, stack<char>& o, stack<st>& op, stack<double>& sk); </code>
 *
 *   kao i njihovu odgovarajuću binarnu operaciju koristeći stack karaktera koji predstavljaju binarne operacije
 *   <code> stack<char> operacija </code> i njihov prioritet <em>('*' > '+' = '-')</em>
 *   @see <code> int prioritetOperacije(char znak); </code>
 *
-*   Rezultujuća matrica je jedina matrica na <code> stack<Matrica*> m </code>
-
-*   , ukoliko je izraz bio ispravan.
+*   Matrica sačuvana na disku navodi se kao <em> {putanja} </em>; proizvodi s njom se računaju blok po blok.
+*   @see <code> class DiskMatrica; </code>
+*
+*   Ukoliko je izraz bio ispravan, na <code> stack<Cvor*> m </code> ostaje samo korijen stabla izraza,
+*   koje se zatim izračunava u zajedničkom bazenu niti, s nezavisnim podizrazima paralelno.
+*   @see <code> Cvor* parsirajIzraz(istream& ulaz, const map<char, pair<int, int>>* promjenljive); </code>
 */
     friend istream& operator >> (istream& ulaz, Matrica& a);
+
+    friend class DiskMatrica;
+    friend class PracenaInverzna;
+    friend struct Cvor;
+    friend class SerijaMatrica;
+    friend class SerijskiIzraz;
+    friend class ModularnaMatrica;
 };
 
+/** \brief Transponovanje kvadratne matrice reda \c red u Morton rasporedu, iz niza \c z u niz \c t.
+*
+*   Kvadranti b i c mijenjaju mjesta, a svaki kvadrant se transponuje rekurzivno, do lista reda
+*   <code> Matrica::listMortona </code> koji se transponuje direktno. Bez parametra bloka, jer
+*   rekurzija sama dolazi do dimenzije koja staje u keš.
+*/
+void transponujMorton(const double* z, double* t, int red);
+
 #endif // MATRICA_H
@@ -0,0 +1,119 @@
+/// \file modularna.cpp
+
+#include "modularna.h"
+#include "bazen.h"
+#include <cmath>
+
+using namespace std;
+
+ModularnaMatrica::ModularnaMatrica(int redovi, int kolone, uint32_t modul):
+    redovi(redovi), kolone(kolone), modul(modul), barrett(0), elementi((size_t)redovi * kolone, 0) {
+    if (modul < 2 || modul >= (1u << 31)) throw "Modul mora biti izmedju 2 i 2^31!";
+    this->barrett = UINT64_MAX / modul;
+}
+
+ModularnaMatrica::ModularnaMatrica(const Matrica& m, uint32_t modul):
+    ModularnaMatrica(m.redovi, m.kolone, modul) {
+    for (int i=0; i<redovi; i++)
+        for (int j=0; j<kolone; j++) {
+            double x = m.matrica[i][j];
+            if (x != floor(x) || !isfinite(x)) throw "Elementi matrice moraju biti cijeli brojevi!";
+            // fmod je tacan i za elemente vece od 2^63
+            double r = fmod(x, (double)modul);
+            if (r < 0) r += modul;
+            elementi[(size_t)i*kolone + j] = (uint32_t)r;
+        }
+}
+
+ModularnaMatrica::ModularnaMatrica(int red, uint32_t modul):
+    ModularnaMatrica(red, red, modul) {
+    for (int i=0; i<red; i++) elementi[(size_t)i*red + i] = 1;
+}
+
+/// Barrettova redukcija: q je najviše za 2 manji od x / modul, pa su dovoljna dva oduzimanja.
+uint32_t ModularnaMatrica::redukuj(uint64_t x) const {
+    uint64_t q = (uint64_t)(((unsigned __int128)x * barrett) >> 64);
+    uint64_t r = x - q * modul;
+    if (r >= modul) r -= modul;
+    if (r >= modul) r -= modul;
+    return (uint32_t)r;
+}
+
+void ModularnaMatrica::provjeriModul(const ModularnaMatrica& a) const {
+    if (this->modul != a.modul) throw "Matrice moraju imati isti modul!";
+}
+
+ModularnaMatrica ModularnaMatrica::operator* (const ModularnaMatrica& a) const {
+    provjeriModul(a);
+    if (this->kolone != a.redovi) throw "Matrice nisu kompatibilne za mnozenje";
+    const int n = this->redovi, m = this->kolone, p = a.kolone;
+    ModularnaMatrica rez(n, p, modul);
+
+    // koliko proizvoda (modul-1)^2 stane u akumulator uz ostatak manji od modula
+    uint64_t maks = (uint64_t)(modul - 1) * (modul - 1);
+    int grupa = maks == 0 ? m : (int)min<uint64_t>((UINT64_MAX - modul) / maks, m);
+    if (grupa < 1) grupa = 1;
+
+    auto poRedovima = [&](int od, int doK) {
+        vector<uint64_t> akumulator(p);
+        for (int i=od; i<doK; i++) {
+            const uint32_t* ai = &elementi[(size_t)i*m];
+            uint64_t* c = akumulator.data();
+            for (int j=0; j<p; j++) c[j] = 0;
+            for (int k0=0; k0<m; k0+=grupa) {
+                int k1 = min(k0 + grupa, m);
+                for (int k=k0; k<k1; k++) {
+                    uint64_t f = ai[k];
+                    const uint32_t* bk = &a.elementi[(size_t)k*p];
+                    for (int j=0; j<p; j++) c[j] += f * bk[j];
+                }
+                for (int j=0; j<p; j++) c[j] = redukuj(c[j]);
+            }
+            uint32_t* ri = &rez.elementi[(size_t)i*p];
+            for (int j=0; j<p; j++) ri[j] = (uint32_t)c[j];
+        }
+    };
+    if ((double)n*m*p < 1e6) poRedovima(0, n);
+    else BazenNiti::globalni().paralelno(0, n, poRedovima);
+    return rez;
+}
+
+ModularnaMatrica ModularnaMatrica::operator+ (const ModularnaMatrica& a) const {
+    provjeriModul(a);
+    if (this->redovi != a.redovi || this->kolone != a.kolone) throw "Matrice za sabiranje nisu odgovarajucih formata";
+    ModularnaMatrica rez(*this);
+    for (size_t i=0; i<elementi.size(); i++) {
+        uint32_t s = rez.elementi[i] + a.elementi[i];
+        rez.elementi[i] = s >= modul ? s - modul : s;
+    }
+    return rez;
+}
+
+ModularnaMatrica ModularnaMatrica::operator- (const ModularnaMatrica& a) const {
+    provjeriModul(a);
+    if (this->redovi != a.redovi || this->kolone != a.kolone) throw "Matrice za oduzimanje nisu odgovarajucih formata";
+    ModularnaMatrica rez(*this);
+    for (size_t i=0; i<elementi.size(); i++) {
+        uint32_t s = rez.elementi[i] + modul - a.elementi[i];
+        rez.elementi[i] = s >= modul ? s - modul : s;
+    }
+    return rez;
+}
+
+ModularnaMatrica ModularnaMatrica::operator^ (unsigned long long stepen) const {
+    if (this->redovi != this->kolone) throw "Samo kvadratne matrice se mogu stepenovati!";
+    ModularnaMatrica rez(redovi, modul), baza(*this);
+    while (stepen > 0) {
+        if (stepen & 1) rez = rez * baza;
+        stepen >>= 1;
+        if (stepen > 0) baza = baza * baza;
+    }
+    return rez;
+}
+
+Matrica ModularnaMatrica::uMatricu() const {
+    Matrica rez(redovi, kolone, neinicijalizovana);
+    for (int i=0; i<redovi; i++)
+        for (int j=0; j<kolone; j++) rez.matrica[i][j] = elementi[(size_t)i*kolone + j];
+    return rez;
+}
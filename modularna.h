@@ -0,0 +1,71 @@
+/// \file modularna.h
+
+#ifndef MODULARNA_H
+#define MODULARNA_H
+#include <cstdint>
+#include <vector>
+#include "matrica.h"
+using namespace std;
+
+/** \class ModularnaMatrica
+* Matrica cijelih brojeva po modulu \c modul, tj. matrica nad prstenom Z<sub>modul</sub>.
+*
+* Služi za tačno računanje velikih stepena (npr. linearnih rekurzija s eksponentom reda milijardi),
+* gdje bi realni brojevi izgubili preciznost ili prekoračili opseg. Elementi se čuvaju kao
+* 32-bitni ostaci, a redukcija se vrši Barrettovom metodom, bez dijeljenja.
+*
+* Izraz <code> [..]^k mod p </code> u parseru se izračunava ovom klasom.
+* @see <code> friend istream& operator >> (istream& ulaz, Matrica& a); </code>
+*/
+
+class ModularnaMatrica {
+    int redovi, kolone;
+    uint32_t modul;
+    uint64_t barrett;
+    vector<uint32_t> elementi;
+
+    ModularnaMatrica(int redovi, int kolone, uint32_t modul);
+    uint32_t redukuj(uint64_t x) const;
+    void provjeriModul(const ModularnaMatrica& a) const;
+public:
+
+/** \brief Svođenje realne matrice po modulu.
+*
+*   Negativni elementi se svode na ostatke iz <code> [0, modul) </code>.
+*   @param modul Modul aritmetike, <code> 2 <= modul < 2<sup>31</sup> </code>. Ne mora biti prost.
+*   @throw exception Izuzetak se baca ukoliko modul nije u dozvoljenom opsegu ili neki element nije cijeli broj.
+*/
+    ModularnaMatrica(const Matrica& m, uint32_t modul);
+
+/// Jedinična matrica reda \c red po modulu \c modul.
+    ModularnaMatrica(int red, uint32_t modul);
+
+    int brojRedova() const { return redovi; }
+    int brojKolona() const { return kolone; }
+    uint32_t dajModul() const { return modul; }
+    uint32_t element(int i, int j) const { return elementi[(size_t)i*kolone + j]; }
+
+/** \brief Modularno množenje matrica.
+*
+*   Proizvodi se sabiraju u 64-bitnim akumulatorima bez redukcije, onoliko puta koliko dozvoljava
+*   veličina modula (za 30-bitni modul 16 puta), pa se redukuje samo jednom po grupi. Unutrašnja
+*   petlja ide po redu desne matrice i akumulatora, tako da je kompajler prevodi u SIMD instrukcije.
+*   @throw exception Izuzetak se baca ukoliko formati ili moduli matrica nisu odgovarajući.
+*/
+    ModularnaMatrica operator* (const ModularnaMatrica& a) const;
+
+    ModularnaMatrica operator+ (const ModularnaMatrica& a) const;
+    ModularnaMatrica operator- (const ModularnaMatrica& a) const;
+
+/** \brief Stepenovanje kvadriranjem, za eksponente do 2<sup>64</sup> - 1.
+*
+*   Koristi <code> 2 log<sub>2</sub>(stepen) </code> množenja; nulti stepen je jedinična matrica.
+*   @throw exception Izuzetak se baca ukoliko matrica nije kvadratna.
+*/
+    ModularnaMatrica operator^ (unsigned long long stepen) const;
+
+/// Pretvaranje u realnu matricu s elementima iz <code> [0, modul) </code>, koji su tačno predstavljeni.
+    Matrica uMatricu() const;
+};
+
+#endif // MODULARNA_H
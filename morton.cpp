@@ -0,0 +1,180 @@
+/// \file morton.cpp
+
+#ifndef MORTON_CPP
+#define MORTON_CPP
+#include <iostream>
+#include <cstring>
+#include <vector>
+#include "matrica.h"
+
+using namespace std;
+
+/// Preplitanje bitova (bi, bj) u Z-indeks bloka: bit j ide na parne, bit i na neparne pozicije.
+static long long zIndeks(int bi, int bj) {
+    long long z = 0;
+    for (int bit=0; bit<31 && (bi >> bit || bj >> bit); bit++) {
+        z |= (long long)((bj >> bit) & 1) << (2*bit);
+        z |= (long long)((bi >> bit) & 1) << (2*bit + 1);
+    }
+    return z;
+}
+
+/** \brief Prevođenje kvadratne matrice reda <code> red </code> (stepen broja 2) u Morton (Z) raspored.
+*
+*   Kvadranti svake razine rekurzije zauzimaju uzastopne dijelove niza, redom a, b, c, d
+*   (gore lijevo, gore desno, dolje lijevo, dolje desno). Redovi lista se kopiraju sa \c memcpy.
+*   @return Dinamički alociran niz od <code> red*red </code> elemenata.
+*/
+double* uMorton(const Matrica& m, int red) {
+    int t = min(red, Matrica::listMortona);
+    double* z = new double[(size_t)red * red];
+    for (int bi=0; bi<red/t; bi++)
+        for (int bj=0; bj<red/t; bj++) {
+            double* list = z + zIndeks(bi, bj) * t * t;
+            for (int i=0; i<t; i++)
+                memcpy(list + i*t, m.matrica[bi*t + i] + bj*t, t * sizeof(double));
+        }
+    return z;
+}
+
+/// Obrnuto od <code> double* uMorton(const Matrica& m, int red); </code>
+Matrica izMortona(const double* z, int red) {
+    int t = min(red, Matrica::listMortona);
+    Matrica rez(red, red, neinicijalizovana);
+    for (int bi=0; bi<red/t; bi++)
+        for (int bj=0; bj<red/t; bj++) {
+            const double* list = z + zIndeks(bi, bj) * t * t;
+            for (int i=0; i<t; i++)
+                memcpy(rez.matrica[bi*t + i] + bj*t, list + i*t, t * sizeof(double));
+        }
+    return rez;
+}
+
+static void saberiZ(const double* a, const double* b, double* c, size_t n) {
+    for (size_t i=0; i<n; i++) c[i] = a[i] + b[i];
+}
+
+static void oduzmiZ(const double* a, const double* b, double* c, size_t n) {
+    for (size_t i=0; i<n; i++) c[i] = a[i] - b[i];
+}
+
+/// Klasično množenje u Morton rasporedu, <code> C += A*B </code>: 8 proizvoda kvadranata do lista reda \c t.
+static void mnoziZ(const double* A, const double* B, double* C, int n, int t) {
+    if (n == t) {
+        for (int i=0; i<n; i++)
+            for (int k=0; k<n; k++) {
+                double l = A[i*n + k];
+                for (int j=0; j<n; j++) C[i*n + j] += l * B[k*n + j];
+            }
+        return;
+    }
+    size_t q = (size_t)(n/2) * (n/2);
+    for (int i=0; i<2; i++)
+        for (int j=0; j<2; j++)
+            for (int k=0; k<2; k++)
+                mnoziZ(A + (2*i + k)*q, B + (2*k + j)*q, C + (2*i + j)*q, n/2, t);
+}
+
+/** \brief Strassenov algoritam nad nizovima u Morton rasporedu.
+*
+*   Kvadranti su uzastopni blokovi, pa nema kopiranja podmatrica kao u
+*   <code> Matrica strassen(Matrica& l, Matrica& d, int red); </code>
+*   Proizvodi p1..p7 se odmah akumuliraju u kvadrante rezultata, tako da svaka razina
+*   koristi samo 3 pomoćna kvadranta iz niza <code> radni </code>. Ispod
+*   <code> Matrica::pragStrassena </code> rekurzija prelazi na klasično množenje.
+*/
+static void strassenZ(const double* A, const double* B, double* C, int n, int t, double* radni) {
+    if (n == t || n < Matrica::pragStrassena) {
+        for (size_t i=0; i<(size_t)n*n; i++) C[i] = 0;
+        mnoziZ(A, B, C, n, t);
+        return;
+    }
+    size_t q = (size_t)(n/2) * (n/2);
+    const double *a = A, *b = A + q, *c = A + 2*q, *d = A + 3*q;
+    const double *e = B, *f = B + q, *g = B + 2*q, *h = B + 3*q;
+    double *c11 = C, *c12 = C + q, *c21 = C + 2*q, *c22 = C + 3*q;
+    double *s = radni, *r = radni + q, *p = radni + 2*q;
+    double* dalje = radni + 3*q;
+
+    oduzmiZ(f, h, r, q);                    // p1 = a(f-h)
+    strassenZ(a, r, p, n/2, t, dalje);
+    for (size_t i=0; i<q; i++) { c12[i] = p[i]; c22[i] = p[i]; }
+
+    saberiZ(a, b, s, q);                    // p2 = (a+b)h
+    strassenZ(s, h, p, n/2, t, dalje);
+    for (size_t i=0; i<q; i++) { c12[i] += p[i]; c11[i] = -p[i]; }
+
+    saberiZ(c, d, s, q);                    // p3 = (c+d)e
+    strassenZ(s, e, p, n/2, t, dalje);
+    for (size_t i=0; i<q; i++) { c21[i] = p[i]; c22[i] -= p[i]; }
+
+    oduzmiZ(g, e, r, q);                    // p4 = d(g-e)
+    strassenZ(d, r, p, n/2, t, dalje);
+    for (size_t i=0; i<q; i++) { c11[i] += p[i]; c21[i] += p[i]; }
+
+    saberiZ(a, d, s, q);                    // p5 = (a+d)(e+h)
+    saberiZ(e, h, r, q);
+    strassenZ(s, r, p, n/2, t, dalje);
+    for (size_t i=0; i<q; i++) { c11[i] += p[i]; c22[i] += p[i]; }
+
+    oduzmiZ(b, d, s, q);                    // p6 = (b-d)(g+h)
+    saberiZ(g, h, r, q);
+    strassenZ(s, r, p, n/2, t, dalje);
+    for (size_t i=0; i<q; i++) c11[i] += p[i];
+
+    oduzmiZ(a, c, s, q);                    // p7 = (a-c)(e+f)
+    saberiZ(e, f, r, q);
+    strassenZ(s, r, p, n/2, t, dalje);
+    for (size_t i=0; i<q; i++) c22[i] -= p[i];
+}
+
+static void transponujZ(const double* A, double* T, int n, int t) {
+    if (n == t) {
+        for (int i=0; i<n; i++)
+            for (int j=0; j<n; j++) T[(size_t)j*n + i] = A[(size_t)i*n + j];
+        return;
+    }
+    size_t q = (size_t)(n/2) * (n/2);
+    transponujZ(A, T, n/2, t);
+    transponujZ(A + q, T + 2*q, n/2, t);
+    transponujZ(A + 2*q, T + q, n/2, t);
+    transponujZ(A + 3*q, T + 3*q, n/2, t);
+}
+
+void transponujMorton(const double* z, double* t, int red) {
+    transponujZ(z, t, red, min(red, Matrica::listMortona));
+}
+
+Matrica transponovanaMorton(const Matrica& m, int red) {
+    double* z = uMorton(m, red);
+    double* t = new double[(size_t)red * red];
+    transponujMorton(z, t, red);
+    Matrica rez(izMortona(t, red));
+    delete [] z;
+    delete [] t;
+    return rez;
+}
+
+/** \brief Strassenovo množenje u Morton rasporedu.
+*
+*   Obje matrice se prevode u Z raspored, množe rekurzivno nad uzastopnim kvadrantima,
+*   a rezultat se vraća u redovni raspored. Prevođenje je O(n<sup>2</sup>), zanemarivo
+*   u odnosu na samo množenje.
+*   @see <code> Matrica strassen(Matrica& l, Matrica& d, int red); </code>
+*/
+Matrica strassenMorton(Matrica& lijeva, Matrica& desna, int red) {
+    int t = min(red, Matrica::listMortona);
+    double* zl = uMorton(lijeva, red);
+    double* zd = uMorton(desna, red);
+    double* zr = new double[(size_t)red * red];
+    // 3 kvadranta po razini: 3n²/4 + 3n²/16 + ... < n²
+    vector<double> radni((size_t)red * red);
+    strassenZ(zl, zd, zr, red, t, radni.data());
+    Matrica rez(izMortona(zr, red));
+    delete [] zl;
+    delete [] zd;
+    delete [] zr;
+    return rez;
+}
+
+#endif // MORTON_CPP
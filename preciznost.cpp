@@ -0,0 +1,161 @@
+/// \file preciznost.cpp
+
+#include "matrica.h"
+#include "bazen.h"
+#include <cmath>
+#include <vector>
+#include <limits>
+
+using namespace std;
+
+atomic<int> Matrica::posljednjeIteracije(0);
+
+/** \brief LU rastav s djelimičnim pivotiranjem, u mjestu.
+*
+*   Matrica \c a (n*n elemenata, red po red) se prepisuje faktorima L (ispod dijagonale, bez jedinica)
+*   i U, a u \c p se upisuje permutacija redova.
+*   @return false ukoliko je matrica singularna u preciznosti tipa \c T.
+*/
+template <typename T>
+static bool luRastavi(vector<T>& a, vector<int>& p, int n) {
+    p.resize(n);
+    for (int i=0; i<n; i++) p[i] = i;
+    for (int k=0; k<n; k++) {
+        int pivot = k;
+        for (int i=k+1; i<n; i++)
+            if (fabs(a[(size_t)i*n + k]) > fabs(a[(size_t)pivot*n + k])) pivot = i;
+        if (a[(size_t)pivot*n + k] == 0) return false;
+        if (pivot != k) {
+            for (int j=0; j<n; j++) swap(a[(size_t)k*n + j], a[(size_t)pivot*n + j]);
+            swap(p[k], p[pivot]);
+        }
+        T* red = &a[(size_t)k*n];
+        for (int i=k+1; i<n; i++) {
+            T* ri = &a[(size_t)i*n];
+            T f = ri[k] / red[k];
+            ri[k] = f;
+            for (int j=k+1; j<n; j++) ri[j] -= f * red[j];
+        }
+    }
+    return true;
+}
+
+/** \brief Rješavanje <code> LUX = PB </code> za \c m desnih strana odjednom.
+*
+*   \c b je matrica formata nxm (red po red) i prepisuje se rješenjem. Unutrašnje petlje
+*   idu po desnim stranama, tj. po uzastopnoj memoriji.
+*/
+template <typename T>
+static void luRijesi(const vector<T>& lu, const vector<int>& p, int n, vector<T>& b, int m) {
+    vector<T> x((size_t)n * m);
+    for (int i=0; i<n; i++)
+        for (int j=0; j<m; j++) x[(size_t)i*m + j] = b[(size_t)p[i]*m + j];
+    for (int i=0; i<n; i++) {
+        T* xi = &x[(size_t)i*m];
+        for (int k=0; k<i; k++) {
+            T f = lu[(size_t)i*n + k];
+            const T* xk = &x[(size_t)k*m];
+            for (int j=0; j<m; j++) xi[j] -= f * xk[j];
+        }
+    }
+    for (int i=n-1; i>=0; i--) {
+        T* xi = &x[(size_t)i*m];
+        for (int k=i+1; k<n; k++) {
+            T f = lu[(size_t)i*n + k];
+            const T* xk = &x[(size_t)k*m];
+            for (int j=0; j<m; j++) xi[j] -= f * xk[j];
+        }
+        T d = lu[(size_t)i*n + i];
+        for (int j=0; j<m; j++) xi[j] /= d;
+    }
+    b.swap(x);
+}
+
+Matrica Matrica::inverznaMjesovita(int* iteracije, bool* dvostruka) {
+    if (this->redovi != this->kolone)
+        throw "Samo kvadratne matrice imaju odgovarajucu inverznu matricu!";
+
+    const int n = this->redovi;
+    const int maxIteracija = 30;
+    size_t nn = (size_t)n * n;
+    vector<double> a(nn), x(nn), r(nn);
+    vector<float> af(nn), rf(nn);
+    vector<int> pf;
+    for (int i=0; i<n; i++)
+        for (int j=0; j<n; j++) {
+            a[(size_t)i*n + j] = this->matrica[i][j];
+            af[(size_t)i*n + j] = (float)this->matrica[i][j];
+        }
+
+    int iter = 0;
+    bool konvergira = luRastavi(af, pf, n);
+    if (konvergira) {
+        // pocetno rjesenje u float preciznosti: A X = I
+        for (size_t i=0; i<nn; i++) rf[i] = 0;
+        for (int i=0; i<n; i++) rf[(size_t)i*n + i] = 1;
+        luRijesi(af, pf, n, rf, n);
+        for (size_t i=0; i<nn; i++) x[i] = rf[i];
+
+        // kriterij kao kod LAPACK dsgesv: ||R|| <= ||X|| * ||A|| * eps * sqrt(n)
+        double normaA = 0;
+        for (int i=0; i<n; i++) {
+            double suma = 0;
+            for (int j=0; j<n; j++) suma += fabs(a[(size_t)i*n + j]);
+            normaA = fmax(normaA, suma);
+        }
+        konvergira = false;
+        double prethodna = numeric_limits<double>::infinity();
+        while (true) {
+            // rezidual R = I - A X u double preciznosti
+            auto rezidual = [&](int od, int doK) {
+                for (int i=od; i<doK; i++) {
+                    double* ri = &r[(size_t)i*n];
+                    for (int j=0; j<n; j++) ri[j] = (i == j);
+                    for (int k=0; k<n; k++) {
+                        double f = a[(size_t)i*n + k];
+                        const double* xk = &x[(size_t)k*n];
+                        for (int j=0; j<n; j++) ri[j] -= f * xk[j];
+                    }
+                }
+            };
+            if ((double)n*n*n < 1e6) rezidual(0, n);
+            else BazenNiti::globalni().paralelno(0, n, rezidual);
+
+            double normaR = 0, normaX = 0;
+            for (size_t i=0; i<nn; i++) {
+                normaR = fmax(normaR, isfinite(r[i]) ? fabs(r[i]) : numeric_limits<double>::infinity());
+                normaX = fmax(normaX, fabs(x[i]));
+            }
+            if (normaR <= normaX * normaA * numeric_limits<double>::epsilon() * sqrt((double)n)) {
+                konvergira = true;
+                break;
+            }
+            // rezidual se ne smanjuje dovoljno brzo, float rastav je prelos za ovu matricu
+            if (iter == maxIteracija || isinf(normaR) || normaR > prethodna / 2) break;
+            prethodna = normaR;
+
+            // korekcija D iz float rastava: A D = R, X = X + D
+            for (size_t i=0; i<nn; i++) rf[i] = (float)r[i];
+            luRijesi(af, pf, n, rf, n);
+            for (size_t i=0; i<nn; i++) x[i] += rf[i];
+            iter++;
+        }
+    }
+
+    if (!konvergira) {
+        vector<int> p;
+        if (!luRastavi(a, p, n)) throw "Matrica mora biti regularna da bi imala inverznu!";
+        for (size_t i=0; i<nn; i++) x[i] = 0;
+        for (int i=0; i<n; i++) x[(size_t)i*n + i] = 1;
+        luRijesi(a, p, n, x, n);
+    }
+
+    if (iteracije) *iteracije = iter;
+    if (dvostruka) *dvostruka = !konvergira;
+    posljednjeIteracije = iter;
+
+    Matrica inv(n, n, neinicijalizovana);
+    for (int i=0; i<n; i++)
+        for (int j=0; j<n; j++) inv.matrica[i][j] = x[(size_t)i*n + j];
+    return inv;
+}
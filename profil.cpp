@@ -0,0 +1,70 @@
+/// \file profil.cpp
+
+#include "matrica.h"
+#include "bazen.h"
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+
+using namespace std;
+
+int Matrica::pragMjesovite = 0;
+int Matrica::pragStrassena = 2;
+int Matrica::listMortona = 32;
+double Matrica::pragParalelnog = 1e6;
+int Matrica::blokTransponovanja = 32;
+
+string Matrica::putanjaProfila() {
+    const char* putanja = getenv("MATRICA_PROFIL");
+    return putanja && *putanja ? putanja : "matrica.profil";
+}
+
+bool Matrica::ucitajProfil(const string& putanja) {
+    ifstream ulaz(putanja);
+    if (!ulaz) return false;
+    string linija;
+    while (getline(ulaz, linija)) {
+        istringstream red(linija);
+        string kljuc, vrijednost;
+        if (!(red >> kljuc >> vrijednost) || kljuc[0] == '#') continue;
+        istringstream broj(vrijednost);
+        double x;
+        if (kljuc == "mnozenje.raspored") {
+            if (vrijednost == "redovni") rasporedMnozenja = redovni;
+            else if (vrijednost == "morton") rasporedMnozenja = morton;
+        } else if (!(broj >> x) || x < 0) {
+            continue;
+        } else if (kljuc == "strassen.prag") {
+            pragStrassena = x > (1 << 30) ? (1 << 30) : (int)x;
+        } else if (kljuc == "morton.list") {
+            // list mora biti stepen broja 2 da bi dijelio kvadrante
+            int list = x >= 1 && x <= 4096 ? (int)x : 0;
+            if (list > 0 && (list & (list - 1)) == 0) listMortona = list;
+        } else if (kljuc == "mnozenje.paralelno") {
+            pragParalelnog = x;
+        } else if (kljuc == "transponovanje.blok") {
+            if (x >= 1 && x <= 4096) blokTransponovanja = (int)x;
+        } else if (kljuc == "inverzna.mjesovita") {
+            pragMjesovite = x > (1 << 30) ? 0 : (int)x;
+        } else if (kljuc == "bazen.niti") {
+            if (x <= 4096) BazenNiti::nitiGlobalnog = (int)x;
+        }
+    }
+    return true;
+}
+
+bool Matrica::zapisiProfil(const string& putanja) {
+    ofstream izlaz(putanja);
+    if (!izlaz) return false;
+    izlaz << "strassen.prag " << pragStrassena << "\n";
+    izlaz << "mnozenje.raspored " << (rasporedMnozenja == morton ? "morton" : "redovni") << "\n";
+    izlaz << "morton.list " << listMortona << "\n";
+    izlaz << "mnozenje.paralelno " << pragParalelnog << "\n";
+    izlaz << "transponovanje.blok " << blokTransponovanja << "\n";
+    izlaz << "inverzna.mjesovita " << pragMjesovite << "\n";
+    izlaz << "bazen.niti " << BazenNiti::nitiGlobalnog << "\n";
+    return (bool)izlaz;
+}
+
+// profil se ucitava prije main-a; parametri postavljeni u programu ga zatim nadjacavaju
+static bool profilUcitan = Matrica::ucitajProfil(Matrica::putanjaProfila());
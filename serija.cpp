@@ -0,0 +1,319 @@
+/// \file serija.cpp
+
+#include "serija.h"
+#include <sstream>
+#include <chrono>
+#include <cmath>
+
+using namespace std;
+
+SerijaMatrica::SerijaMatrica(int redovi, int kolone, int broj):
+    redovi(redovi), kolone(kolone), broj(broj), podaci((size_t)redovi * kolone * broj, 0) {
+    if (redovi <= 0 || kolone <= 0 || broj <= 0) throw "Neispravan format serije matrica!";
+}
+
+void SerijaMatrica::postavi(int k, const Matrica& m) {
+    if (m.redovi != redovi || m.kolone != kolone) throw "Matrica nije odgovarajuceg formata za seriju!";
+    if (k < 0 || k >= broj) throw "Ilegalna pozicija u seriji!";
+    for (int i=0; i<redovi; i++)
+        for (int j=0; j<kolone; j++) element(i, j)[k] = m.matrica[i][j];
+}
+
+Matrica SerijaMatrica::uzmi(int k) const {
+    if (k < 0 || k >= broj) throw "Ilegalna pozicija u seriji!";
+    Matrica m(redovi, kolone, neinicijalizovana);
+    for (int i=0; i<redovi; i++)
+        for (int j=0; j<kolone; j++) m.matrica[i][j] = element(i, j)[k];
+    return m;
+}
+
+/// Pogled na međurezultat: element \c e, matrica \c x serije je na <code> baza[e*korak + x] </code>.
+struct Pogled {
+    double* baza;
+    size_t korak;
+    double* operator() (int e) const { return baza + e * korak; }
+};
+
+/// Množenje serija, <code> o = l * d </code>, formata (r x k) * (k x c); \c o se ne smije preklapati s operandima.
+static void pomnozi(Pogled l, Pogled d, Pogled o, int r, int k, int c, int duzina) {
+    for (int i=0; i<r; i++)
+        for (int j=0; j<c; j++) {
+            double* oij = o(i*c + j);
+            for (int x=0; x<duzina; x++) oij[x] = 0;
+            for (int t=0; t<k; t++) {
+                const double* a = l(i*k + t);
+                const double* b = d(t*c + j);
+                for (int x=0; x<duzina; x++) oij[x] += a[x] * b[x];
+            }
+        }
+}
+
+static void kopiraj(Pogled iz, Pogled u, int elemenata, int duzina) {
+    for (int e=0; e<elemenata; e++) {
+        const double* a = iz(e);
+        double* b = u(e);
+        for (int x=0; x<duzina; x++) b[x] = a[x];
+    }
+}
+
+/** \brief Determinanta podmatrice (zadati redovi i kolone) za svaku matricu serije.
+*
+*   Razvoj po prvom redu, kao u <code> double Matrica::determinanta(); </code>, ali se svaki korak
+*   izvršava nad svim trakama odjednom.
+*/
+static void determinanta(Pogled m, int n, const vector<int>& redovi, const vector<int>& kolone,
+                         int duzina, double* izlaz) {
+    int k = redovi.size();
+    if (k == 1) {
+        const double* a = m(redovi[0]*n + kolone[0]);
+        for (int x=0; x<duzina; x++) izlaz[x] = a[x];
+        return;
+    }
+    if (k == 2) {
+        const double* a = m(redovi[0]*n + kolone[0]);
+        const double* b = m(redovi[0]*n + kolone[1]);
+        const double* c = m(redovi[1]*n + kolone[0]);
+        const double* d = m(redovi[1]*n + kolone[1]);
+        for (int x=0; x<duzina; x++) izlaz[x] = a[x]*d[x] - b[x]*c[x];
+        return;
+    }
+    vector<int> podRedovi(redovi.begin() + 1, redovi.end()), podKolone;
+    vector<double> minor(duzina);
+    for (int x=0; x<duzina; x++) izlaz[x] = 0;
+    for (int t=0; t<k; t++) {
+        podKolone.clear();
+        for (int s=0; s<k; s++) if (s != t) podKolone.push_back(kolone[s]);
+        determinanta(m, n, podRedovi, podKolone, duzina, minor.data());
+        const double* a = m(redovi[0]*n + kolone[t]);
+        double znak = t % 2 ? -1 : 1;
+        for (int x=0; x<duzina; x++) izlaz[x] += znak * a[x] * minor[x];
+    }
+}
+
+/// Inverzna matrica svake matrice serije, <code> A<sup>-1</sup> = adj(A) / det(A) </code>.
+static void invertuj(Pogled m, Pogled o, int n, int duzina) {
+    vector<int> sve(n);
+    for (int i=0; i<n; i++) sve[i] = i;
+    vector<double> det(duzina), kofaktor(duzina);
+    determinanta(m, n, sve, sve, duzina, det.data());
+    for (int x=0; x<duzina; x++)
+        if (det[x] == 0) throw "Matrica mora biti regularna da bi imala inverznu!";
+    if (n == 1) {
+        for (int x=0; x<duzina; x++) o(0)[x] = 1 / det[x];
+        return;
+    }
+    for (int i=0; i<n; i++)
+        for (int j=0; j<n; j++) {
+            vector<int> r, k;
+            for (int s=0; s<n; s++) {
+                if (s != j) r.push_back(s);
+                if (s != i) k.push_back(s);
+            }
+            determinanta(m, n, r, k, duzina, kofaktor.data());
+            double znak = (i+j) % 2 ? -1 : 1;
+            double* oij = o(i*n + j);
+            for (int x=0; x<duzina; x++) oij[x] = znak * kofaktor[x] / det[x];
+        }
+}
+
+/** \brief Inverzna matrica svake matrice serije, Gauss-Jordanovom eliminacijom s djelimičnim pivotiranjem.
+*
+*   Izbor pivota i zamjena redova se rade traku po traku (O(n) po koloni), a sama eliminacija,
+*   koja je O(n<sup>2</sup>) po koloni, nad svim trakama odjednom.
+*/
+static void gaussJordan(Pogled m, Pogled o, int n, int duzina) {
+    vector<double> radni((size_t)n * n * duzina);
+    Pogled a{radni.data(), (size_t)duzina};
+    kopiraj(m, a, n*n, duzina);
+    for (int i=0; i<n; i++)
+        for (int j=0; j<n; j++) {
+            double* oij = o(i*n + j);
+            for (int x=0; x<duzina; x++) oij[x] = (i == j);
+        }
+    vector<double> f(duzina);
+    for (int k=0; k<n; k++) {
+        for (int x=0; x<duzina; x++) {
+            int pivot = k;
+            for (int i=k+1; i<n; i++)
+                if (fabs(a(i*n + k)[x]) > fabs(a(pivot*n + k)[x])) pivot = i;
+            if (a(pivot*n + k)[x] == 0) throw "Matrica mora biti regularna da bi imala inverznu!";
+            if (pivot != k)
+                for (int j=0; j<n; j++) {
+                    swap(a(k*n + j)[x], a(pivot*n + j)[x]);
+                    swap(o(k*n + j)[x], o(pivot*n + j)[x]);
+                }
+            f[x] = 1 / a(k*n + k)[x];
+        }
+        for (int j=0; j<n; j++) {
+            double* akj = a(k*n + j);
+            double* okj = o(k*n + j);
+            for (int x=0; x<duzina; x++) {
+                akj[x] *= f[x];
+                okj[x] *= f[x];
+            }
+        }
+        for (int i=0; i<n; i++) {
+            if (i == k) continue;
+            const double* aik = a(i*n + k);
+            for (int x=0; x<duzina; x++) f[x] = aik[x];
+            for (int j=0; j<n; j++) {
+                double* aij = a(i*n + j);
+                double* oij = o(i*n + j);
+                const double* akj = a(k*n + j);
+                const double* okj = o(k*n + j);
+                for (int x=0; x<duzina; x++) {
+                    aij[x] -= f[x] * akj[x];
+                    oij[x] -= f[x] * okj[x];
+                }
+            }
+        }
+    }
+}
+
+SerijskiIzraz::SerijskiIzraz(const string& izraz, const map<char, pair<int, int>>& formati):
+    formati(formati), propusnost(0) {
+    istringstream ulaz(izraz);
+    Cvor* korijen = parsirajIzraz(ulaz, &this->formati);
+    try {
+        prevedi(korijen);
+    } catch (...) {
+        for (size_t i=0; i<program.size(); i++) delete program[i].konstanta;
+        delete korijen;
+        throw;
+    }
+    delete korijen;
+}
+
+SerijskiIzraz::~SerijskiIzraz() {
+    for (size_t i=0; i<program.size(); i++) delete program[i].konstanta;
+}
+
+int SerijskiIzraz::prevedi(Cvor* c) {
+    if (c->modul) throw "Modularno stepenovanje nije podrzano u serijama!";
+    if (c->naDisku) throw "Matrice na disku nisu podrzane u serijama!";
+    Instrukcija in;
+    in.tip = c->tip;
+    in.znak = c->znak;
+    in.stepen = c->stepen;
+    in.faktor = c->faktor;
+    in.redovi = c->redovi;
+    in.kolone = c->kolone;
+    in.konstanta = nullptr;
+    in.lijevi = c->lijevi ? prevedi(c->lijevi) : -1;
+    in.desni = c->desni ? prevedi(c->desni) : -1;
+    if (c->tip == ulazna) in.konstanta = new Matrica(*c->vrijednost);
+    program.push_back(in);
+    return program.size() - 1;
+}
+
+SerijaMatrica SerijskiIzraz::izvrsi(const map<char, const SerijaMatrica*>& ulazi) {
+    auto pocetak = chrono::steady_clock::now();
+    int broj = -1;
+    for (size_t p=0; p<program.size(); p++) {
+        if (program[p].tip != promjenljiva) continue;
+        auto u = ulazi.find(program[p].znak);
+        if (u == ulazi.end()) throw "Nepoznata promjenljiva!";
+        const SerijaMatrica* s = u->second;
+        if (s->brojRedova() != program[p].redovi || s->brojKolona() != program[p].kolone)
+            throw "Serija nije odgovarajuceg formata!";
+        if (broj != -1 && broj != s->brojMatrica()) throw "Serije moraju imati isti broj matrica!";
+        broj = s->brojMatrica();
+    }
+    if (broj == -1) throw "Izraz nema promjenljivih!";
+
+    const Instrukcija& zadnja = program.back();
+    SerijaMatrica rez(zadnja.redovi, zadnja.kolone, broj);
+
+    const size_t B = sirinaBloka;
+    vector<vector<double>> registri(program.size());
+    size_t najveci = 0;
+    for (size_t p=0; p<program.size(); p++) {
+        if (program[p].tip != promjenljiva)
+            registri[p].resize((size_t)program[p].redovi * program[p].kolone * B);
+        if (program[p].tip == stepenovanje)
+            najveci = max(najveci, (size_t)program[p].redovi * program[p].kolone * B);
+    }
+    vector<double> pomocni1(najveci), pomocni2(najveci);
+    vector<Pogled> pogledi(program.size());
+
+    for (int b0=0; b0<broj; b0+=B) {
+        int duzina = min((int)B, broj - b0);
+        for (size_t p=0; p<program.size(); p++) {
+            const Instrukcija& in = program[p];
+            if (in.tip == promjenljiva) {
+                const SerijaMatrica* s = ulazi.find(in.znak)->second;
+                pogledi[p] = Pogled{const_cast<double*>(s->element(0, 0)) + b0, (size_t)broj};
+                continue;
+            }
+            Pogled o{registri[p].data(), B};
+            pogledi[p] = o;
+            int elemenata = in.redovi * in.kolone;
+            if (in.tip == ulazna) {
+                for (int i=0; i<in.redovi; i++)
+                    for (int j=0; j<in.kolone; j++) {
+                        double v = in.konstanta->matrica[i][j];
+                        double* oij = o(i*in.kolone + j);
+                        for (int x=0; x<duzina; x++) oij[x] = v;
+                    }
+                continue;
+            }
+            Pogled l = pogledi[in.lijevi];
+            if (in.tip == skaliranje) {
+                for (int e=0; e<elemenata; e++) {
+                    const double* a = l(e);
+                    double* oe = o(e);
+                    for (int x=0; x<duzina; x++) oe[x] = in.faktor * a[x];
+                }
+            } else if (in.tip == transponovanje) {
+                for (int i=0; i<in.redovi; i++)
+                    for (int j=0; j<in.kolone; j++) {
+                        const double* a = l(j*in.redovi + i);
+                        double* oij = o(i*in.kolone + j);
+                        for (int x=0; x<duzina; x++) oij[x] = a[x];
+                    }
+            } else if (in.tip == invertovanje) {
+                // kofaktori su bez grananja i jeftini samo za male matrice
+                if (in.redovi <= 4) invertuj(l, o, in.redovi, duzina);
+                else gaussJordan(l, o, in.redovi, duzina);
+            } else if (in.tip == stepenovanje) {
+                // kvadriranje i mnozenje, kao u Matrica operator^ (int stepen)
+                int n = in.redovi;
+                Pogled baza{pomocni1.data(), B}, privremena{pomocni2.data(), B};
+                kopiraj(l, baza, elemenata, duzina);
+                bool prvi = true;
+                for (int s=in.stepen; s>0; s/=2) {
+                    if (s % 2) {
+                        if (prvi) kopiraj(baza, o, elemenata, duzina);
+                        else {
+                            pomnozi(o, baza, privremena, n, n, n, duzina);
+                            kopiraj(privremena, o, elemenata, duzina);
+                        }
+                        prvi = false;
+                    }
+                    if (s > 1) {
+                        pomnozi(baza, baza, privremena, n, n, n, duzina);
+                        swap(baza, privremena);
+                    }
+                }
+            } else {
+                Pogled d = pogledi[in.desni];
+                if (in.znak == '*') pomnozi(l, d, o, in.redovi, program[in.lijevi].kolone, in.kolone, duzina);
+                else {
+                    double predznak = in.znak == '-' ? -1 : 1;
+                    for (int e=0; e<elemenata; e++) {
+                        const double* a = l(e);
+                        const double* b = d(e);
+                        double* oe = o(e);
+                        for (int x=0; x<duzina; x++) oe[x] = a[x] + predznak * b[x];
+                    }
+                }
+            }
+        }
+        Pogled izlaz{rez.element(0, 0) + b0, (size_t)broj};
+        kopiraj(pogledi.back(), izlaz, zadnja.redovi * zadnja.kolone, duzina);
+    }
+
+    double sekunde = chrono::duration<double>(chrono::steady_clock::now() - pocetak).count();
+    propusnost = sekunde > 0 ? broj / sekunde : 0;
+    return rez;
+}
@@ -0,0 +1,96 @@
+/// \file serija.h
+
+#ifndef SERIJA_H
+#define SERIJA_H
+#include <string>
+#include <vector>
+#include <map>
+#include "matrica.h"
+#include "izraz.h"
+using namespace std;
+
+/** \class SerijaMatrica
+* Niz od \c broj matrica istog formata, sačuvan kao struktura nizova (structure-of-arrays).
+*
+* Element <code> (i, j) </code> svih matrica serije zauzima uzastopan dio memorije, pa se
+* ista operacija nad čitavom serijom izvršava SIMD instrukcijama, po jedna matrica u svakoj traci.
+*/
+
+class SerijaMatrica {
+    int redovi, kolone, broj;
+    vector<double> podaci;
+public:
+
+/// Kreira seriju od \c broj nul-matrica formata redovi x kolone.
+    SerijaMatrica(int redovi, int kolone, int broj);
+
+    int brojRedova() const { return redovi; }
+    int brojKolona() const { return kolone; }
+    int brojMatrica() const { return broj; }
+
+/// Niz od \c broj vrijednosti elementa <code> (i, j) </code>, po jedna za svaku matricu serije.
+    double* element(int i, int j) { return &podaci[((size_t)i*kolone + j) * broj]; }
+    const double* element(int i, int j) const { return &podaci[((size_t)i*kolone + j) * broj]; }
+
+/// Upisivanje matrice na poziciju \c k serije.
+    void postavi(int k, const Matrica& m);
+
+/// Izdvajanje matrice sa pozicije \c k serije.
+    Matrica uzmi(int k) const;
+};
+
+/** \class SerijskiIzraz
+* Izraz koji se parsira jednom, a izračunava nad čitavim serijama matrica.
+*
+* Izraz se piše kao i za <code> friend istream& operator >> (istream& ulaz, Matrica& a); </code>,
+* uz promjenljive označene velikim slovima (osim \c E i \c I), npr. <code> A^-1 * B + C^T </code>.
+* Stablo izraza se prevodi u niz instrukcija, a serija se obrađuje u dijelovima od po
+* \c sirinaBloka matrica, kako bi svi međurezultati jednog dijela ostali u kešu.
+*/
+
+class SerijskiIzraz {
+    struct Instrukcija {
+        tipCvora tip;
+        char znak;
+        int stepen;
+        double faktor;
+        int lijevi, desni;
+        int redovi, kolone;
+        Matrica* konstanta;
+    };
+    vector<Instrukcija> program;
+    map<char, pair<int, int>> formati;
+    double propusnost;
+
+    int prevedi(Cvor* c);
+public:
+
+/// Broj matrica serije koje se obrađuju zajedno.
+    static const int sirinaBloka = 256;
+
+/** \brief Parsiranje i prevođenje izraza.
+*
+*   @param izraz Tekst izraza.
+*   @param formati Format (redovi, kolone) svake promjenljive.
+*   @throw exception Izuzetak se baca pri sintaksnoj grešci ili neodgovarajućim formatima.
+*/
+    SerijskiIzraz(const string& izraz, const map<char, pair<int, int>>& formati);
+
+    SerijskiIzraz(const SerijskiIzraz&) = delete;
+    SerijskiIzraz& operator= (const SerijskiIzraz&) = delete;
+    ~SerijskiIzraz();
+
+/** \brief Izračunavanje izraza nad serijama.
+*
+*   @param ulazi Serija za svaku promjenljivu izraza; sve serije moraju imati isti broj matrica.
+*   @return Serija rezultata, u istom rasporedu kao i ulazi.
+*   @throw exception Izuzetak se baca ukoliko neka promjenljiva nema seriju odgovarajućeg formata,
+*   ili je neka od matrica koje se invertuju singularna.
+*/
+    SerijaMatrica izvrsi(const map<char, const SerijaMatrica*>& ulazi);
+
+/// Propusnost posljednjeg izvršavanja, u matricama po sekundi.
+    double posljednjaPropusnost() const { return propusnost; }
+};
+
+#endif // SERIJA_H
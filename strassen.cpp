@@ -13,7 +13,8 @@ using namespace std;
 *
 *   Ideja je da se množenje svede na 7 rekurzivnih poziva, za razliku od 8 kod klasičnog množenja.
 *
-*   Matrice se dijele na 4 podmatrice koje su reda <code> red/2 </code>, rekurzija staje kad matrice dosegnu red 2.
+*   Matrice se dijele na 4 podmatrice koje su reda <code> red/2 </code>, rekurzija staje kad matrice dosegnu red 2
+*   ili red manji od <code> Matrica::pragStrassena </code>, kada se množi klasično.
 *   Neka su *a,b,c,d* podmatrice(kvadranti) lijeve matrice, a *e,f,g,h* podmatrice desne matrice respektivno. Tada su
 *   pomoćne matrice (označimo ih sa p1, p2,.., p7):
 *   \code
@@ -42,61 +43,83 @@ using namespace std;
 *   matrice <code> lijeva </code>i <code> desna. <code>
 */
 Matrica strassen(Matrica& lijeva, Matrica& desna, int red) {
-    Matrica* rez = new Matrica(red, red);
+    Matrica rez(red, red, neinicijalizovana);
+    if (red < Matrica::pragStrassena || red < 2) {
+        // ispod praga klasicno mnozenje, redom i-k-j da bi unutrasnja petlja isla po redu
+        for (int i=0; i<red; i++) {
+            double* r = rez.matrica[i];
+            for (int j=0; j<red; j++) r[j] = 0;
+            for (int k=0; k<red; k++) {
+                double l = lijeva.matrica[i][k];
+                const double* d = desna.matrica[k];
+                for (int j=0; j<red; j++) r[j] += l * d[j];
+            }
+        }
+        return rez;
+    }
     if (red == 2) {
-        int p1 = lijeva.matrica[0][0]*(desna.matrica[0][1]-desna.matrica[1][1]); // p1 = a(f-h)
-        int p2 = (lijeva.matrica[0][0]+lijeva.matrica[0][1])*desna.matrica[1][1]; //p2 = (a+b)h
-        int p3 = (lijeva.matrica[1][0]+lijeva.matrica[1][1])*desna.matrica[0][0]; //p3 = (c+d)e
-        int p4 =  lijeva.matrica[1][1]*(desna.matrica[1][0]-desna.matrica[0][0]); //p4 = d(g-e)
-        int p5 = (lijeva.matrica[0][0]+lijeva.matrica[1][1])*(desna.matrica[0][0]+desna.matrica[1][1]); // p5 = (a+d)(e+h)
-        int p6 = (lijeva.matrica[0][1]-lijeva.matrica[1][1])*(desna.matrica[1][0]+desna.matrica[1][1]); //p6 = (b-d)(g+h)
-        int p7 = (lijeva.matrica[0][0]-lijeva.matrica[1][0])*(desna.matrica[0][0]+desna.matrica[0][1]); // p7 = (a-c)(e+f)
+        double p1 = lijeva.matrica[0][0]*(desna.matrica[0][1]-desna.matrica[1][1]); // p1 = a(f-h)
+        double p2 = (lijeva.matrica[0][0]+lijeva.matrica[0][1])*desna.matrica[1][1]; //p2 = (a+b)h
+        double p3 = (lijeva.matrica[1][0]+lijeva.matrica[1][1])*desna.matrica[0][0]; //p3 = (c+d)e
+        double p4 =  lijeva.matrica[1][1]*(desna.matrica[1][0]-desna.matrica[0][0]); //p4 = d(g-e)
+        double p5 = (lijeva.matrica[0][0]+lijeva.matrica[1][1])*(desna.matrica[0][0]+desna.matrica[1][1]); // p5 = (a+d)(e+h)
+        double p6 = (lijeva.matrica[0][1]-lijeva.matrica[1][1])*(desna.matrica[1][0]+desna.matrica[1][1]); //p6 = (b-d)(g+h)
+        double p7 = (lijeva.matrica[0][0]-lijeva.matrica[1][0])*(desna.matrica[0][0]+desna.matrica[0][1]); // p7 = (a-c)(e+f)
 
-        rez->matrica[0][0] = p5+p4-p2+p6;
-        rez->matrica[0][1] = p1+p2;
-        rez->matrica[1][0] = p3+p4;
-        rez->matrica[1][1] = p1+p5-p3-p7;
+        rez.matrica[0][0] = p5+p4-p2+p6;
+        rez.matrica[0][1] = p1+p2;
+        rez.matrica[1][0] = p3+p4;
+        rez.matrica[1][1] = p1+p5-p3-p7;
 
-        return *rez;
+        return rez;
     }
+    const int m = red/2;
+    // kvadranti se odmah prepisuju, pa se ne popunjavaju nulama
     Matrica
-        a(red/2, red/2), b(red/2, red/2), c(red/2, red/2), d(red/2, red/2),
-        e(red/2, red/2), f(red/2, red/2), g(red/2, red/2), h(red/2, red/2),
-        c11(red/2, red/2), c12(red/2, red/2), c21(red/2, red/2), c22(red/2, red/2),
-        p1(red/2, red/2), p2(red/2, red/2), p3(red/2, red/2), p4(red/2, red/2),
-        p5(red/2, red/2), p6(red/2, red/2), p7(red/2, red/2),
-        pomocni1(red/2, red/2), pomocni2(red/2, red/2);
+        a(m, m, neinicijalizovana), b(m, m, neinicijalizovana), c(m, m, neinicijalizovana), d(m, m, neinicijalizovana),
+        e(m, m, neinicijalizovana), f(m, m, neinicijalizovana), g(m, m, neinicijalizovana), h(m, m, neinicijalizovana);
 
-    for (int i=0; i<red/2; i++) {
-        for (int j=0; j<red/2; j++) {
+    for (int i=0; i<m; i++) {
+        for (int j=0; j<m; j++) {
             a.matrica[i][j] = lijeva.matrica[i][j];
-            b.matrica[i][j] = lijeva.matrica[i][j+red/2];
-            c.matrica[i][j] = lijeva.matrica[i+red/2][j];
-            d.matrica[i][j] = lijeva.matrica[i+red/2][j+red/2];
+            b.matrica[i][j] = lijeva.matrica[i][j+m];
+            c.matrica[i][j] = lijeva.matrica[i+m][j];
+            d.matrica[i][j] = lijeva.matrica[i+m][j+m];
 
             e.matrica[i][j] = desna.matrica[i][j];
-            f.matrica[i][j] = desna.matrica[i][j+red/2];
-            g.matrica[i][j] = desna.matrica[i+red/2][j];
-            h.matrica[i][j] = desna.matrica[i+red/2][j+red/2];
+            f.matrica[i][j] = desna.matrica[i][j+m];
+            g.matrica[i][j] = desna.matrica[i+m][j];
+            h.matrica[i][j] = desna.matrica[i+m][j+m];
         }
     }
-    pomocni1 = f-h;
-    p1 = strassen(a, pomocni1, red/2);
-    pomocni2 = a+b;
-    p2 = strassen(pomocni2, h, red/2);
-    pomocni1 = c+d;
-    p3 = strassen(pomocni1, e, red/2);
-    pomocni2 = g-e;
-    p4 = strassen(d, pomocni2, red/2);
-    pomocni1 = a+d;
-    pomocni2 = e+h;
-    p5 = strassen(pomocni1, pomocni2, red/2);
-    pomocni1 = b-d;
-    pomocni2 = g+h;
-    p6 = strassen(pomocni1, pomocni2, red/2);
-    pomocni1 = a-c;
-    pomocni2 = e+f;
-    p7 = strassen(pomocni1, pomocni2, red/2);
+    // pomocne matrice se racunaju na mjestu (+=, -=), a dodjela kvadranta ponovo koristi njihov prostor
+    Matrica pomocni1(f);
+    pomocni1 -= h;
+    Matrica p1(strassen(a, pomocni1, m));
+    Matrica pomocni2(a);
+    pomocni2 += b;
+    Matrica p2(strassen(pomocni2, h, m));
+    pomocni1 = c;
+    pomocni1 += d;
+    Matrica p3(strassen(pomocni1, e, m));
+    pomocni2 = g;
+    pomocni2 -= e;
+    Matrica p4(strassen(d, pomocni2, m));
+    pomocni1 = a;
+    pomocni1 += d;
+    pomocni2 = e;
+    pomocni2 += h;
+    Matrica p5(strassen(pomocni1, pomocni2, m));
+    pomocni1 = b;
+    pomocni1 -= d;
+    pomocni2 = g;
+    pomocni2 += h;
+    Matrica p6(strassen(pomocni1, pomocni2, m));
+    pomocni1 = a;
+    pomocni1 -= c;
+    pomocni2 = e;
+    pomocni2 += f;
+    Matrica p7(strassen(pomocni1, pomocni2, m));
 
     /*
     c11 = p5+p4-p2+p6;
@@ -105,24 +128,15 @@ Matrica strassen(Matrica& lijeva, Matrica& desna, int red) {
     c22 = p1+p5-p3-p7;
     */
 
-    pomocni1 = p5+p4;
-    pomocni2 = p6+pomocni1;
-    c11 = pomocni2-p2;
-    c12 = p1+p2;
-    c21 = p3+p4;
-    pomocni1 = p1+p5;
-    pomocni2 = pomocni1-p3;
-    c22 = pomocni2-p7;
-
-    for (int i=0; i<red/2; i++) {
-        for (int j=0; j<red/2; j++) {
-            rez->matrica[i][j] = c11.matrica[i][j];
-            rez->matrica[i][j+red/2] = c12.matrica[i][j];
-            rez->matrica[i+red/2][j] = c21.matrica[i][j];
-            rez->matrica[i+red/2][j+red/2] = c22.matrica[i][j];
+    for (int i=0; i<m; i++) {
+        for (int j=0; j<m; j++) {
+            rez.matrica[i][j] = p5.matrica[i][j] + p4.matrica[i][j] - p2.matrica[i][j] + p6.matrica[i][j];
+            rez.matrica[i][j+m] = p1.matrica[i][j] + p2.matrica[i][j];
+            rez.matrica[i+m][j] = p3.matrica[i][j] + p4.matrica[i][j];
+            rez.matrica[i+m][j+m] = p1.matrica[i][j] + p5.matrica[i][j] - p3.matrica[i][j] - p7.matrica[i][j];
         }
     }
-    return *rez;
+    return rez;
 }
 
 #endif // STRASSEN_CPP